@@ -0,0 +1,151 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace resourceguard::bench
+ * @brief Minimal, dependency-free microbenchmark harness
+ * 
+ * Each benchmark is a callable taking an iteration count and running its own loop, so the
+ * measured time excludes any per-iteration call overhead of the harness. Results are emitted
+ * as JSON so they can be diffed between builds to catch regressions.
+ */
+namespace resourceguard::bench {
+
+    /**
+     * @brief Prevents the compiler from optimizing away a value
+     * @param value The value to keep alive
+     */
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Prevents the compiler from reordering or eliding memory accesses across this point
+     */
+    inline void clobber_memory() {
+        asm volatile("" : : : "memory");
+    }
+
+    /**
+     * @brief Result of a single benchmark
+     */
+    struct Result {
+        std::string name;          ///< Operation being measured
+        std::string subject;       ///< Implementation being measured
+        std::uint64_t iterations;  ///< Iterations of the fastest repetition
+        double ns_per_op;          ///< Nanoseconds per iteration of the fastest repetition
+    };
+
+    /**
+     * @class Runner
+     * @brief Calibrates, runs and reports benchmarks
+     * 
+     * Recognized command line options:
+     *   --filter=<substring>   only run benchmarks whose "name/subject" contains the substring
+     *   --min-time=<seconds>   minimum duration of each repetition (default 0.1)
+     *   --repetitions=<n>      repetitions per benchmark, the fastest is reported (default 3)
+     *   --out=<path>           write JSON to a file instead of stdout
+     */
+    class Runner {
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<Result> m_results;
+        std::string m_filter;
+        std::string m_out;
+        double m_min_time = 0.1;
+        int m_repetitions = 3;
+
+        template<typename Fn>
+        static double time_once(Fn& fn, std::uint64_t iterations) {
+            auto start = Clock::now();
+            fn(iterations);
+            clobber_memory();
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+    public:
+        /**
+         * @brief Constructs a Runner from the command line
+         * 
+         * @param argc Argument count
+         * @param argv Argument values
+         */
+        Runner(int argc, char** argv) {
+            for (int i = 1; i < argc; ++i) {
+                const char* arg = argv[i];
+                if (std::strncmp(arg, "--filter=", 9) == 0) m_filter = arg + 9;
+                else if (std::strncmp(arg, "--min-time=", 11) == 0) m_min_time = std::atof(arg + 11);
+                else if (std::strncmp(arg, "--repetitions=", 14) == 0) m_repetitions = std::atoi(arg + 14);
+                else if (std::strncmp(arg, "--out=", 6) == 0) m_out = arg + 6;
+                else std::fprintf(stderr, "Ignoring unknown option %s\n", arg);
+            }
+            if (m_repetitions < 1) m_repetitions = 1;
+        }
+
+        /**
+         * @brief Calibrates and runs a benchmark, recording the fastest repetition
+         * 
+         * @param name The operation being measured
+         * @param subject The implementation being measured
+         * @param fn Callable taking the iteration count and running that many iterations
+         */
+        template<typename Fn>
+        void run(const char* name, const char* subject, Fn&& fn) {
+            std::string id = std::string(name) + "/" + subject;
+            if (!m_filter.empty() && id.find(m_filter) == std::string::npos) return;
+
+            std::uint64_t iterations = 1;
+            double elapsed = time_once(fn, iterations);
+            while (elapsed < m_min_time / 10 && iterations < (std::uint64_t(1) << 40)) {
+                iterations *= 10;
+                elapsed = time_once(fn, iterations);
+            }
+            if (elapsed > 0) {
+                double scaled = static_cast<double>(iterations) * m_min_time / elapsed;
+                if (scaled > static_cast<double>(iterations)) iterations = static_cast<std::uint64_t>(scaled);
+            }
+
+            double best = time_once(fn, iterations);
+            for (int r = 1; r < m_repetitions; ++r) {
+                double t = time_once(fn, iterations);
+                if (t < best) best = t;
+            }
+            m_results.push_back({name, subject, iterations, best * 1e9 / static_cast<double>(iterations)});
+            std::fprintf(stderr, "%-48s %10.3f ns/op\n", id.c_str(), m_results.back().ns_per_op);
+        }
+
+        /**
+         * @brief Writes all results as JSON
+         * 
+         * @param suite Name of the benchmark suite
+         * @return 0 on success, 1 if the output file could not be opened
+         */
+        int report(const char* suite) const {
+            std::FILE* out = m_out.empty() ? stdout : std::fopen(m_out.c_str(), "w");
+            if (!out) {
+                std::fprintf(stderr, "Cannot open %s\n", m_out.c_str());
+                return 1;
+            }
+            std::fprintf(out, "{\n  \"suite\": \"%s\",\n  \"min_time\": %g,\n  \"repetitions\": %d,\n  \"benchmarks\": [\n",
+                         suite, m_min_time, m_repetitions);
+            for (std::size_t i = 0; i < m_results.size(); ++i) {
+                const Result& r = m_results[i];
+                std::fprintf(out, "    {\"name\": \"%s\", \"subject\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.4f}%s\n",
+                             r.name.c_str(), r.subject.c_str(), static_cast<unsigned long long>(r.iterations),
+                             r.ns_per_op, i + 1 < m_results.size() ? "," : "");
+            }
+            std::fprintf(out, "  ]\n}\n");
+            if (out != stdout) std::fclose(out);
+            return 0;
+        }
+    };
+
+} // namespace resourceguard::bench
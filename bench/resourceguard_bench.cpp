@@ -0,0 +1,922 @@
+/**
+ * @file resourceguard_bench.cpp
+ * @brief Microbenchmarks of ResourceGuard against a raw handle, std::unique_ptr and a scope guard
+ * 
+ * Build and run from the repository root:
+ * 
+ *   g++ -std=c++17 -O2 -pthread -I. bench/resourceguard_bench.cpp -o resourceguard_bench
+ *   ./resourceguard_bench --out=bench_output.txt
+ * 
+ * The tests under tests/ carry their own build commands.
+ * 
+ * The managed "handle" is a pointer into a static pool and the deleter only makes the pointer
+ * observable to the optimizer, so the numbers isolate the bookkeeping cost of each wrapper.
+ */
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+#include "resourceguard_arena.hpp"
+#include "resourceguard_array.hpp"
+#include "resourceguard_deferred.hpp"
+#include "resourceguard_epoch.hpp"
+#include "resourceguard_exitstack.hpp"
+#include "resourceguard_hazard.hpp"
+#include "resourceguard_reclaim.hpp"
+#include "resourceguard_retire.hpp"
+#include "resourceguard_scan.hpp"
+#include "resourceguard_shared.hpp"
+#include "resourceguard_vector.hpp"
+#include "bench/harness.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief File descriptor with -1 as its sentinel, so scan_valid() vectorizes it
+ */
+enum class ScanFd : int {};
+
+template<>
+struct resourceguard::ResourceTraits<ScanFd> : resourceguard::SentinelTraits<ScanFd, ScanFd{-1}> {};
+
+using namespace resourceguard;
+using namespace resourceguard::bench;
+
+namespace {
+
+    int g_pool[64];
+
+    inline int* acquire(std::uint64_t i) noexcept { return &g_pool[i & 63]; }
+
+    inline void close_handle(int* p) noexcept { do_not_optimize(p); }
+
+    struct Closer {
+        void operator()(int* p) const noexcept { close_handle(p); }
+    };
+
+    struct MayThrowCloser {
+        void operator()(int* p) const { close_handle(p); }
+    };
+
+    using Guard = ResourceGuard<Closer, int*>;
+    using MayThrowGuard = ResourceGuard<MayThrowCloser, int*>;
+    using FnGuard = FnResourceGuard<&close_handle, int*>;
+    using UncheckedGuard = BasicResourceGuard<NoCheck, Closer, int*>;
+    using UniquePtr = std::unique_ptr<int, Closer>;
+
+    /**
+     * @brief Hand-written scope guard, the usual alternative to a generic RAII wrapper
+     */
+    template<typename F>
+    class ScopeExit {
+        F m_fn;
+        bool m_active = true;
+
+    public:
+        explicit ScopeExit(F fn) : m_fn(std::move(fn)) {}
+        ScopeExit(ScopeExit&& other) noexcept : m_fn(std::move(other.m_fn)), m_active(other.m_active) {
+            other.m_active = false;
+        }
+        ~ScopeExit() { if (m_active) m_fn(); }
+        void run() noexcept {
+            if (m_active) m_fn();
+            m_active = false;
+        }
+        void dismiss() noexcept { m_active = false; }
+    };
+
+    inline auto make_scope_exit(int* p) {
+        return ScopeExit([p] { close_handle(p); });
+    }
+
+    constexpr std::size_t bulk_size = 1024;
+    constexpr std::size_t scan_size = 4096;
+    constexpr std::size_t growth_size = 100000;
+    constexpr std::size_t request_buffers = 256;
+
+    /**
+     * @brief Deleter standing in for a close() that blocks on I/O for about 20us
+     */
+    struct BlockingCloser {
+        void operator()(int fd) const noexcept {
+            do_not_optimize(fd);
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    };
+
+    /**
+     * @brief 64-byte block handed out by the pools of the cross-thread benchmarks
+     */
+    struct Block {
+        Block* next;
+        char payload[56];
+    };
+
+    constexpr std::size_t release_threads = 4;
+
+    thread_local Block* t_block_pool = nullptr;
+
+    inline Block* local_alloc() {
+        if (Block* b = t_block_pool) {
+            t_block_pool = b->next;
+            return b;
+        }
+        return new Block;
+    }
+
+    /**
+     * @brief Returns a block to the calling thread's pool; only correct on the allocating thread
+     */
+    struct LocalFree {
+        void operator()(Block* b) const noexcept {
+            b->next = t_block_pool;
+            t_block_pool = b;
+        }
+    };
+
+    std::mutex g_block_mutex;
+    Block* g_block_pool = nullptr;
+
+    inline Block* shared_alloc() {
+        std::lock_guard<std::mutex> lock(g_block_mutex);
+        if (Block* b = g_block_pool) {
+            g_block_pool = b->next;
+            return b;
+        }
+        return new Block;
+    }
+
+    /**
+     * @brief Returns a block to the pool shared by all threads
+     */
+    struct SharedFree {
+        void operator()(Block* b) const noexcept {
+            std::lock_guard<std::mutex> lock(g_block_mutex);
+            b->next = g_block_pool;
+            g_block_pool = b;
+        }
+    };
+
+    /**
+     * @brief Allocates n guarded blocks on this thread and releases them on release_threads others
+     *
+     * The allocating thread keeps running `safe_point` until the workers are done.
+     */
+    template<typename Guard, typename Make, typename SafePoint>
+    void release_across_threads(std::uint64_t n, Make make, SafePoint safe_point) {
+        std::vector<Guard> guards;
+        guards.reserve(n);
+        for (std::uint64_t i = 0; i < n; ++i) guards.push_back(make());
+        std::atomic<std::size_t> running{release_threads};
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < release_threads; ++t) {
+            workers.emplace_back([&guards, &running, n, t] {
+                for (std::uint64_t i = t; i < n; i += release_threads) guards[i].release();
+                running.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        while (running.load(std::memory_order_acquire) != 0) safe_point();
+        for (std::thread& worker : workers) worker.join();
+        safe_point();
+    }
+
+    /**
+     * @brief Splits n iterations of fn across the given number of threads and waits for them
+     */
+    template<typename Fn>
+    void run_on_threads(std::size_t threads, std::uint64_t n, Fn fn) {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&fn, n, threads, t] { fn(n / threads + (t < n % threads ? 1 : 0)); });
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    /**
+     * @brief Hands a copy of `guard` to each of `threads` threads, which copy and drop it n times in total
+     *
+     * The handed copies are made on the calling thread and dropped on the workers, so biased
+     * counting takes its cross-thread path. The calling thread runs `safe_point` at the end.
+     */
+    template<typename Guard, typename SafePoint>
+    void share_across_threads(std::size_t threads, std::uint64_t n, Guard guard, SafePoint safe_point) {
+        std::vector<Guard> handed(threads, guard);
+        guard = Guard();
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            std::uint64_t m = n / threads + (t < n % threads ? 1 : 0);
+            workers.emplace_back([held = std::move(handed[t]), m]() mutable {
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    Guard copy = held;
+                    do_not_optimize(copy);
+                }
+                held = Guard();
+            });
+        }
+        for (std::thread& worker : workers) worker.join();
+        safe_point();
+    }
+
+    struct DeleteInt {
+        void operator()(int* p) const noexcept { delete p; }
+    };
+
+    struct FreeBuffer {
+        void operator()(char* p) const noexcept { std::free(p); }
+    };
+
+    /**
+     * @brief Handles for the scan benchmarks, every third one released
+     */
+    std::vector<int*> make_scan_handles() {
+        std::vector<int*> handles(scan_size);
+        for (std::size_t i = 0; i < scan_size; ++i) handles[i] = i % 3 ? acquire(i) : nullptr;
+        return handles;
+    }
+
+    std::vector<ScanFd> make_scan_fds() {
+        std::vector<ScanFd> fds(scan_size);
+        for (std::size_t i = 0; i < scan_size; ++i) fds[i] = ScanFd{i % 3 ? static_cast<int>(i) : -1};
+        return fds;
+    }
+
+    struct FdCloser {
+        void operator()(int fd) const noexcept { do_not_optimize(fd); }
+    };
+
+    /**
+     * @brief Virtual-base wrapper, the usual way to store heterogeneous guards
+     */
+    struct ErasedGuard {
+        virtual ~ErasedGuard() = default;
+    };
+
+    template<typename G>
+    struct ErasedGuardImpl final : ErasedGuard {
+        G guard;
+        explicit ErasedGuardImpl(G&& g) : guard(std::move(g)) {}
+    };
+
+    template<typename G>
+    std::unique_ptr<ErasedGuard> make_erased(G&& guard) {
+        return std::make_unique<ErasedGuardImpl<G>>(std::move(guard));
+    }
+
+#if defined(__linux__)
+    constexpr std::size_t fd_count = 512;
+
+    struct CloseFd {
+        void operator()(int fd) const noexcept { close(fd); }
+    };
+
+    struct CloseFdRange {
+        void operator()(int fd) const noexcept { close(fd); }
+        void destroy_batch(int* fds, std::size_t count) const noexcept {
+            for_each_contiguous_run(fds, count, [](int first, int last) {
+                syscall(SYS_close_range, static_cast<unsigned>(first), static_cast<unsigned>(last), 0u);
+            });
+        }
+    };
+#endif
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Runner runner(argc, argv);
+
+    // construct_destroy: acquire a handle into the wrapper and let it go out of scope
+    runner.run("construct_destroy", "raw", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            int* h = acquire(i);
+            do_not_optimize(h);
+            close_handle(h);
+        }
+    });
+    runner.run("construct_destroy", "unique_ptr", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            UniquePtr p(acquire(i));
+            do_not_optimize(p);
+        }
+    });
+    runner.run("construct_destroy", "scope_exit", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto s = make_scope_exit(acquire(i));
+            do_not_optimize(s);
+        }
+    });
+    runner.run("construct_destroy", "ResourceGuard", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Guard g(Closer{}, acquire(i));
+            do_not_optimize(g);
+        }
+    });
+    runner.run("construct_destroy", "ResourceGuard<MayThrow>", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            MayThrowGuard g(MayThrowCloser{}, acquire(i));
+            do_not_optimize(g);
+        }
+    });
+    runner.run("construct_destroy", "FnResourceGuard", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            FnGuard g(FunctionDeleter<&close_handle>{}, acquire(i));
+            do_not_optimize(g);
+        }
+    });
+
+    // move_construct: transfer ownership into a new wrapper
+    runner.run("move_construct", "raw", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            int* a = acquire(i);
+            do_not_optimize(a);
+            int* b = a;
+            a = nullptr;
+            do_not_optimize(a);
+            do_not_optimize(b);
+            close_handle(b);
+        }
+    });
+    runner.run("move_construct", "unique_ptr", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            UniquePtr a(acquire(i));
+            do_not_optimize(a);
+            UniquePtr b(std::move(a));
+            do_not_optimize(b);
+        }
+    });
+    runner.run("move_construct", "scope_exit", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto a = make_scope_exit(acquire(i));
+            do_not_optimize(a);
+            auto b(std::move(a));
+            do_not_optimize(b);
+        }
+    });
+    runner.run("move_construct", "ResourceGuard", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Guard a(Closer{}, acquire(i));
+            do_not_optimize(a);
+            Guard b(std::move(a));
+            do_not_optimize(b);
+        }
+    });
+
+    // move_assign: replace an owning wrapper, disposing of its previous handle
+    runner.run("move_assign", "unique_ptr", [](std::uint64_t n) {
+        UniquePtr a(acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            UniquePtr b(acquire(i));
+            do_not_optimize(b);
+            a = std::move(b);
+            do_not_optimize(a);
+        }
+    });
+    runner.run("move_assign", "ResourceGuard", [](std::uint64_t n) {
+        Guard a(Closer{}, acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Guard b(Closer{}, acquire(i));
+            do_not_optimize(b);
+            a = std::move(b);
+            do_not_optimize(a);
+        }
+    });
+
+    // get: checked access to the managed handle
+    runner.run("get", "raw", [](std::uint64_t n) {
+        int* h = acquire(1);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(h);
+            int* v = h;
+            do_not_optimize(v);
+        }
+    });
+    runner.run("get", "unique_ptr", [](std::uint64_t n) {
+        UniquePtr p(acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(p);
+            int* v = p.get();
+            do_not_optimize(v);
+        }
+    });
+    runner.run("get", "ResourceGuard", [](std::uint64_t n) {
+        Guard g(Closer{}, acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            int* v = g.get();
+            do_not_optimize(v);
+        }
+    });
+
+    runner.run("get", "ResourceGuard<NoCheck>", [](std::uint64_t n) {
+        UncheckedGuard g(Closer{}, acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            int* v = g.get();
+            do_not_optimize(v);
+        }
+    });
+
+    // try_get: non-throwing access returning an optional
+    runner.run("try_get", "unique_ptr", [](std::uint64_t n) {
+        UniquePtr p(acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(p);
+            int* v = p ? p.get() : nullptr;
+            do_not_optimize(v);
+        }
+    });
+    runner.run("try_get", "ResourceGuard", [](std::uint64_t n) {
+        Guard g(Closer{}, acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            auto v = g.try_get();
+            int* h = v ? v->get() : nullptr;
+            do_not_optimize(h);
+        }
+    });
+
+    // set / try_set: overwrite the managed handle without disposing of it
+    runner.run("set", "raw", [](std::uint64_t n) {
+        int* h = acquire(0);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(h);
+            h = acquire(i);
+            do_not_optimize(h);
+        }
+    });
+    runner.run("set", "ResourceGuard", [](std::uint64_t n) {
+        Guard g(Closer{}, acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            g.set(acquire(i));
+            do_not_optimize(g);
+        }
+    });
+    runner.run("set", "ResourceGuard<NoCheck>", [](std::uint64_t n) {
+        UncheckedGuard g(Closer{}, acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            g.set(acquire(i));
+            do_not_optimize(g);
+        }
+    });
+    runner.run("try_set", "ResourceGuard", [](std::uint64_t n) {
+        Guard g(Closer{}, acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            int r = g.try_set(acquire(i));
+            do_not_optimize(r);
+        }
+    });
+
+    // reset: dispose of the current handle and take ownership of a new one
+    runner.run("reset", "unique_ptr", [](std::uint64_t n) {
+        UniquePtr p(acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(p);
+            p.reset(acquire(i));
+            do_not_optimize(p);
+        }
+    });
+    runner.run("reset", "ResourceGuard", [](std::uint64_t n) {
+        Guard g(Closer{}, acquire(0));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(g);
+            g.reset(acquire(i));
+            do_not_optimize(g);
+        }
+    });
+
+    // steal: give up ownership without running the deleter
+    runner.run("steal", "unique_ptr", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            UniquePtr p(acquire(i));
+            do_not_optimize(p);
+            int* h = p.release();
+            do_not_optimize(h);
+        }
+    });
+    runner.run("steal", "scope_exit", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            int* h = acquire(i);
+            auto s = make_scope_exit(h);
+            do_not_optimize(s);
+            s.dismiss();
+            do_not_optimize(h);
+        }
+    });
+    runner.run("steal", "ResourceGuard", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Guard g(Closer{}, acquire(i));
+            do_not_optimize(g);
+            auto h = g.steal();
+            do_not_optimize(h);
+        }
+    });
+
+    // release: run the deleter before the wrapper goes out of scope
+    runner.run("release", "unique_ptr", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            UniquePtr p(acquire(i));
+            do_not_optimize(p);
+            p.reset();
+            do_not_optimize(p);
+        }
+    });
+    runner.run("release", "scope_exit", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            auto s = make_scope_exit(acquire(i));
+            do_not_optimize(s);
+            s.run();
+            do_not_optimize(s);
+        }
+    });
+    runner.run("release", "ResourceGuard", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            Guard g(Closer{}, acquire(i));
+            do_not_optimize(g);
+            g.release();
+            do_not_optimize(g);
+        }
+    });
+
+    // bulk_teardown: fill a collection with 1024 guarded fds and destroy them all
+    runner.run("bulk_teardown_1024", "vector<ResourceGuard>", [](std::uint64_t n) {
+        std::vector<ResourceGuard<FdCloser, int>> guards;
+        guards.reserve(bulk_size);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t fd = 0; fd < bulk_size; ++fd) guards.emplace_back(FdCloser{}, static_cast<int>(fd));
+            do_not_optimize(guards.data());
+            guards.clear();
+        }
+    });
+    runner.run("bulk_teardown_1024", "ResourceGuardArray", [](std::uint64_t n) {
+        ResourceGuardArray<FdCloser, int> guards;
+        guards.reserve(bulk_size);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t fd = 0; fd < bulk_size; ++fd) guards.push_back(static_cast<int>(fd));
+            do_not_optimize(guards.data());
+            guards.clear();
+        }
+    });
+    // heterogeneous_teardown: fill a list with 1024 guards of alternating types and destroy it
+    runner.run("heterogeneous_teardown_1024", "vector<unique_ptr<Base>>", [](std::uint64_t n) {
+        std::vector<std::unique_ptr<ErasedGuard>> guards;
+        guards.reserve(bulk_size);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < bulk_size; k += 2) {
+                guards.push_back(make_erased(ResourceGuard<FdCloser, int>(FdCloser{}, static_cast<int>(k))));
+                guards.push_back(make_erased(Guard(Closer{}, acquire(k))));
+            }
+            do_not_optimize(guards.data());
+            guards.clear();
+        }
+    });
+    runner.run("heterogeneous_teardown_1024", "vector<AnyResourceGuard>", [](std::uint64_t n) {
+        std::vector<AnyResourceGuard<>> guards;
+        guards.reserve(bulk_size);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < bulk_size; k += 2) {
+                guards.emplace_back(ResourceGuard<FdCloser, int>(FdCloser{}, static_cast<int>(k)));
+                guards.emplace_back(Guard(Closer{}, acquire(k)));
+            }
+            do_not_optimize(guards.data());
+            guards.clear();
+        }
+    });
+
+    // exit_stack: acquire a variable number (here 6) of resources in one scope and unwind them
+    runner.run("exit_stack_6", "vector<ResourceGuard>", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::vector<Guard> guards;
+            for (std::size_t k = 0; k < 6; ++k) guards.emplace_back(Closer{}, acquire(i + k));
+            do_not_optimize(guards.data());
+        }
+    });
+    runner.run("exit_stack_6", "ExitStack", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            ExitStack<> stack;
+            for (std::size_t k = 0; k < 6; ++k) stack.emplace(Closer{}, acquire(i + k));
+            do_not_optimize(stack);
+        }
+    });
+
+    // request_scope: 256 guarded 64-byte buffers per request, all released at request end
+    runner.run("request_scope_256", "vector<ResourceGuard>+malloc", [](std::uint64_t n) {
+        std::vector<ResourceGuard<FreeBuffer, char*>> guards;
+        guards.reserve(request_buffers);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < request_buffers; ++k) {
+                guards.emplace_back(FreeBuffer{}, static_cast<char*>(std::malloc(64)));
+            }
+            do_not_optimize(guards.data());
+            guards.clear();
+        }
+    });
+    runner.run("request_scope_256", "Arena+ArenaDeleter", [](std::uint64_t n) {
+        Arena arena;
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < request_buffers; ++k) {
+                do_not_optimize(arena.make_guard(ArenaDeleter{}, arena.allocate_array<char>(64)));
+            }
+            arena.reset();
+        }
+    });
+
+    // blocking_deleter: destroy guards whose deleter blocks for ~20us
+    runner.run("blocking_deleter", "ResourceGuard (inline)", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            ResourceGuard<BlockingCloser, int> fd(BlockingCloser{}, static_cast<int>(i));
+            do_not_optimize(fd);
+        }
+    });
+    runner.run("blocking_deleter", "ResourceGuard<Async>, 4 workers", [](std::uint64_t n) {
+        AsyncReclaimer reclaimer({ 4096, 4, Backpressure::Block });
+        for (std::uint64_t i = 0; i < n; ++i) {
+            ResourceGuard<Async<BlockingCloser>, int> fd(Async<BlockingCloser>(reclaimer), static_cast<int>(i));
+            do_not_optimize(fd);
+        }
+        reclaimer.drain();
+    });
+
+    // shared_create / shared_copy: shared ownership of a handle, creation vs. copy-and-drop
+    // (after blocking_deleter has started threads, so libstdc++ no longer skips atomics as single-threaded)
+    runner.run("shared_create", "shared_ptr+deleter", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::shared_ptr<int> fd(acquire(i), Closer{});
+            do_not_optimize(fd);
+        }
+    });
+    runner.run("shared_create", "SharedResourceGuard", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            SharedResourceGuard<Closer, int*> fd(Closer{}, acquire(i));
+            do_not_optimize(fd);
+        }
+    });
+    runner.run("shared_copy", "shared_ptr+deleter", [](std::uint64_t n) {
+        std::shared_ptr<int> fd(acquire(1), Closer{});
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::shared_ptr<int> copy = fd;
+            do_not_optimize(copy);
+        }
+    });
+    runner.run("shared_copy", "SharedResourceGuard", [](std::uint64_t n) {
+        SharedResourceGuard<Closer, int*> fd(Closer{}, acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            SharedResourceGuard<Closer, int*> copy = fd;
+            do_not_optimize(copy);
+        }
+    });
+    runner.run("shared_copy", "LocalSharedResourceGuard", [](std::uint64_t n) {
+        LocalSharedResourceGuard<Closer, int*> fd(Closer{}, acquire(1));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            LocalSharedResourceGuard<Closer, int*> copy = fd;
+            do_not_optimize(copy);
+        }
+    });
+
+    // owner_copy: each thread copies and drops a guard it created, as with per-connection state
+    // (biased counting stays on its non-atomic owner path; cross_thread_copy measures the other one)
+    for (std::size_t threads : {1, 4, 16, 64}) {
+        std::string subject = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        runner.run("owner_copy", ("shared_ptr+deleter, " + subject).c_str(), [threads](std::uint64_t n) {
+            run_on_threads(threads, n, [](std::uint64_t m) {
+                std::shared_ptr<int> fd(acquire(m), Closer{});
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    std::shared_ptr<int> copy = fd;
+                    do_not_optimize(copy);
+                }
+            });
+        });
+        runner.run("owner_copy", ("SharedResourceGuard, " + subject).c_str(), [threads](std::uint64_t n) {
+            run_on_threads(threads, n, [](std::uint64_t m) {
+                SharedResourceGuard<Closer, int*> fd(Closer{}, acquire(m));
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    SharedResourceGuard<Closer, int*> copy = fd;
+                    do_not_optimize(copy);
+                }
+            });
+        });
+        runner.run("owner_copy", ("BiasedSharedResourceGuard, " + subject).c_str(), [threads](std::uint64_t n) {
+            run_on_threads(threads, n, [](std::uint64_t m) {
+                BiasedSharedResourceGuard<Closer, int*> fd(Closer{}, acquire(m));
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    BiasedSharedResourceGuard<Closer, int*> copy = fd;
+                    do_not_optimize(copy);
+                }
+            });
+        });
+        // cross_thread_copy: one guard, created here, copied and dropped on every worker
+        runner.run("cross_thread_copy", ("shared_ptr+deleter, " + subject).c_str(), [threads](std::uint64_t n) {
+            share_across_threads(threads, n, std::shared_ptr<int>(acquire(1), Closer{}), [] {});
+        });
+        runner.run("cross_thread_copy", ("SharedResourceGuard, " + subject).c_str(), [threads](std::uint64_t n) {
+            share_across_threads(threads, n, SharedResourceGuard<Closer, int*>(Closer{}, acquire(1)), [] {});
+        });
+        runner.run("cross_thread_copy", ("BiasedSharedResourceGuard, " + subject).c_str(), [threads](std::uint64_t n) {
+            share_across_threads(threads, n, BiasedSharedResourceGuard<Closer, int*>(Closer{}, acquire(1)),
+                                 [] { collect_retired(); });
+        });
+    }
+
+    // cross_thread_release: blocks from a per-thread pool, released by 4 other threads
+    runner.run("cross_thread_release", "mutex-protected shared pool", [](std::uint64_t n) {
+        release_across_threads<ResourceGuard<SharedFree, Block*>>(
+            n, [] { return ResourceGuard<SharedFree, Block*>(SharedFree{}, shared_alloc()); },
+            [] { std::this_thread::yield(); });
+    });
+    runner.run("cross_thread_release", "HomeThread retire list", [](std::uint64_t n) {
+        using HomeGuard = ResourceGuard<HomeThread<LocalFree>, Block*>;
+        release_across_threads<HomeGuard>(
+            n, [] { return HomeGuard(HomeThread<LocalFree>(), local_alloc()); },
+            [] {
+                collect_retired();
+                std::this_thread::yield();
+            });
+    });
+
+    // read_mostly_lookup: readers load the current version of a shared table entry
+    runner.run("read_mostly_lookup", "atomic_load(shared_ptr)", [](std::uint64_t n) {
+        auto table = std::make_shared<int>(1);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::shared_ptr<int> entry = std::atomic_load(&table);
+            do_not_optimize(*entry);
+        }
+    });
+    runner.run("read_mostly_lookup", "EpochPin+atomic<T*>", [](std::uint64_t n) {
+        std::atomic<int*> table{new int(1)};
+        for (std::uint64_t i = 0; i < n; ++i) {
+            EpochPin pin;
+            do_not_optimize(*table.load(std::memory_order_acquire));
+        }
+        epoch_retire(ResourceGuard<std::default_delete<int>, int*>(std::default_delete<int>(), table.load()));
+        epoch_barrier();
+    });
+
+    // hazard_protect / hazard_retire: per-operation cost with 1 to 8 threads sharing one pointer
+    for (std::size_t threads : {1, 2, 4, 8}) {
+        std::string subject = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        runner.run("hazard_protect", ("HazardPointer, " + subject).c_str(), [threads](std::uint64_t n) {
+            std::atomic<int*> shared{new int(1)};
+            run_on_threads(threads, n, [&shared](std::uint64_t m) {
+                HazardPointer hp;
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    do_not_optimize(*hp.protect(shared));
+                    hp.reset();
+                }
+            });
+            delete shared.load();
+        });
+        runner.run("hazard_protect", ("EpochPin, " + subject).c_str(), [threads](std::uint64_t n) {
+            std::atomic<int*> shared{new int(1)};
+            run_on_threads(threads, n, [&shared](std::uint64_t m) {
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    EpochPin pin;
+                    do_not_optimize(*shared.load(std::memory_order_acquire));
+                }
+            });
+            delete shared.load();
+        });
+        runner.run("hazard_retire", ("HazardRetire, " + subject).c_str(), [threads](std::uint64_t n) {
+            std::atomic<int*> shared{new int(1)};
+            run_on_threads(threads, n, [&shared](std::uint64_t m) {
+                HazardPointer hp;
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    do_not_optimize(*hp.protect(shared));
+                    hp.reset();
+                    ResourceGuard<HazardRetire<DeleteInt>, int*> old(HazardRetire<DeleteInt>(),
+                                                                      shared.exchange(new int(1)));
+                }
+                hazard_reclaim();
+            });
+            delete shared.load();
+        });
+    }
+
+    // growth: push 100k guards without reserving, so every reallocation relocates the table
+    runner.run("growth_100k", "vector<ResourceGuard>", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::vector<ResourceGuard<FdCloser, int>> guards;
+            for (std::size_t fd = 0; fd < growth_size; ++fd) guards.emplace_back(FdCloser{}, static_cast<int>(fd));
+            do_not_optimize(guards.data());
+        }
+    });
+    runner.run("growth_100k", "GuardVector<ResourceGuard>", [](std::uint64_t n) {
+        for (std::uint64_t i = 0; i < n; ++i) {
+            GuardVector<ResourceGuard<FdCloser, int>> guards;
+            for (std::size_t fd = 0; fd < growth_size; ++fd) guards.emplace_back(FdCloser{}, static_cast<int>(fd));
+            do_not_optimize(guards.data());
+        }
+    });
+
+#if defined(__linux__)
+    // bulk_close: open 512 real descriptors into a collection and close them all
+    runner.run("bulk_close_512", "vector<ResourceGuard>", [](std::uint64_t n) {
+        int base = open("/dev/null", O_RDONLY);
+        std::vector<ResourceGuard<CloseFd, int>> guards;
+        guards.reserve(fd_count);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < fd_count; ++k) guards.emplace_back(CloseFd{}, dup(base));
+            guards.clear();
+        }
+        close(base);
+    });
+    runner.run("bulk_close_512", "ResourceGuardArray+close_range", [](std::uint64_t n) {
+        int base = open("/dev/null", O_RDONLY);
+        ResourceGuardArray<CloseFdRange, int> guards;
+        guards.reserve(fd_count);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < fd_count; ++k) guards.push_back(dup(base));
+            guards.clear();
+        }
+        close(base);
+    });
+    // deferred_close: open and drop 512 individually guarded descriptors, one at a time
+    runner.run("deferred_close_512", "ResourceGuard (immediate)", [](std::uint64_t n) {
+        int base = open("/dev/null", O_RDONLY);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < fd_count; ++k) {
+                ResourceGuard<CloseFd, int> fd(CloseFd{}, dup(base));
+                do_not_optimize(fd);
+            }
+        }
+        close(base);
+    });
+    runner.run("deferred_close_512", "ResourceGuard<Deferred>+close_range", [](std::uint64_t n) {
+        int base = open("/dev/null", O_RDONLY);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            for (std::size_t k = 0; k < fd_count; ++k) {
+                ResourceGuard<Deferred<CloseFdRange, 64>, int> fd(Deferred<CloseFdRange, 64>{}, dup(base));
+                do_not_optimize(fd);
+            }
+            flush_deferred();
+        }
+        close(base);
+    });
+#endif
+
+    // valid_scan: bitmap of the non-null handles among 4096 pointers
+    runner.run("valid_scan_4096", "ValidityCheck loop", [](std::uint64_t n) {
+        std::vector<int*> handles = make_scan_handles();
+        std::vector<std::uint64_t> bits(scan_size / 64);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(handles.data());
+            for (std::size_t k = 0; k < scan_size; ++k) {
+                if (k % 64 == 0) bits[k / 64] = 0;
+                bits[k / 64] |= std::uint64_t(ValidityCheck<int* const&>::check(handles[k])) << (k % 64);
+            }
+            do_not_optimize(bits.data());
+        }
+    });
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (level > simd_level()) break;
+        static const char* const names[] = {"scan_valid<Scalar>", "scan_valid<SSE2>", "scan_valid<AVX2>"};
+        runner.run("valid_scan_4096", names[static_cast<int>(level)], [level](std::uint64_t n) {
+            std::vector<int*> handles = make_scan_handles();
+            std::vector<std::uint64_t> bits(scan_size / 64);
+            for (std::uint64_t i = 0; i < n; ++i) {
+                do_not_optimize(handles.data());
+                scan_valid(handles.data(), scan_size, bits.data(), level);
+                do_not_optimize(bits.data());
+            }
+        });
+    }
+
+    // valid_fd_scan: the same over 4-byte fds, -1 meaning closed
+    runner.run("valid_fd_scan_4096", "fd != -1 loop", [](std::uint64_t n) {
+        std::vector<ScanFd> fds = make_scan_fds();
+        std::vector<std::uint64_t> bits(scan_size / 64);
+        for (std::uint64_t i = 0; i < n; ++i) {
+            do_not_optimize(fds.data());
+            for (std::size_t k = 0; k < scan_size; ++k) {
+                if (k % 64 == 0) bits[k / 64] = 0;
+                bits[k / 64] |= std::uint64_t(fds[k] != ScanFd{-1}) << (k % 64);
+            }
+            do_not_optimize(bits.data());
+        }
+    });
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2}) {
+        if (level > simd_level()) break;
+        static const char* const names[] = {"scan_valid<Scalar>", "scan_valid<SSE2>", "scan_valid<AVX2>"};
+        runner.run("valid_fd_scan_4096", names[static_cast<int>(level)], [level](std::uint64_t n) {
+            std::vector<ScanFd> fds = make_scan_fds();
+            std::vector<std::uint64_t> bits(scan_size / 64);
+            for (std::uint64_t i = 0; i < n; ++i) {
+                do_not_optimize(fds.data());
+                scan_valid(fds.data(), scan_size, bits.data(), level);
+                do_not_optimize(bits.data());
+            }
+        });
+    }
+
+    return runner.report("resourceguard");
+}
@@ -1,11 +1,34 @@
 #pragma once
 
-#include <iostream>
 #include <tuple>
+#include <functional>
 #include <utility>
 #include <stdexcept>
 #include <type_traits>
 #include <optional>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define RESOURCEGUARD_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define RESOURCEGUARD_COLD __declspec(noinline)
+#else
+#define RESOURCEGUARD_COLD
+#endif
+
+#ifndef RESOURCEGUARD_HAS_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define RESOURCEGUARD_HAS_EXCEPTIONS 1
+#else
+#define RESOURCEGUARD_HAS_EXCEPTIONS 0
+#endif
+#endif
 
 /**
  * @namespace resourceguard
@@ -17,6 +40,19 @@
  */
 namespace resourceguard {
 
+    namespace detail {
+
+        /**
+         * @brief Base of the built-in ValidityCheck templates
+         *
+         * Their check() accepts every value except, at most, the type's sentinel, so code that
+         * already tests the sentinel (see scan_valid()) can skip calling them. User
+         * specializations do not derive from it and are always called.
+         */
+        struct SentinelValidity {};
+
+    } // namespace detail
+
     /**
      * @brief Default trait for validity checking of resources
      * 
@@ -26,7 +62,7 @@ namespace resourceguard {
      * @tparam T The resource type to check
      */
     template<typename T>
-    struct ValidityCheck {
+    struct ValidityCheck : detail::SentinelValidity {
         /**
          * @brief Checks if a resource is valid
          * @param resource The resource to check
@@ -43,7 +79,7 @@ namespace resourceguard {
      * @tparam T The pointed-to type
      */
     template<typename T>
-    struct ValidityCheck<T*> {
+    struct ValidityCheck<T*> : detail::SentinelValidity {
         /**
          * @brief Checks if a pointer is valid (non-null)
          * @param p The pointer to check
@@ -60,301 +96,1923 @@ namespace resourceguard {
      * @tparam T The pointed-to type
      */
     template<typename T>
-    struct ValidityCheck<T* const&> {
+    struct ValidityCheck<T* const&> : detail::SentinelValidity {
+        /**
+         * @brief Checks if a pointer reference is valid (non-null)
+         * @param p The pointer reference to check
+         * @return true if pointer is not null, false otherwise
+         */
+        static bool check(T* const& p) { return p != nullptr; }
+    };
+
+    /**
+     * @brief Describes how the "no resource" state of a type is represented
+     * 
+     * A resource type with a sentinel value (an empty/null handle) lets a single-resource
+     * ResourceGuard encode its released state inside the resource itself instead of keeping
+     * a separate flag. The default implementation declares no sentinel, so the guard falls back
+     * to tracking release with a flag.
+     * 
+     * Specialize this template for your own handle types, either by deriving from SentinelTraits
+     * or by providing `has_sentinel` and a `sentinel()` function directly (useful when the value
+     * is not a constant expression, e.g. `MAP_FAILED`):
+     * 
+     * @code
+     * enum class Fd : int {};
+     * template<> struct resourceguard::ResourceTraits<Fd> : resourceguard::SentinelTraits<Fd, Fd{-1}> {};
+     * 
+     * struct Mapping { void* addr; std::size_t size; bool operator==(const Mapping&) const = default; };
+     * template<> struct resourceguard::ResourceTraits<Mapping> {
+     *     static constexpr bool has_sentinel = true;
+     *     static Mapping sentinel() noexcept { return { MAP_FAILED, 0 }; }
+     * };
+     * @endcode
+     * 
+     * @tparam T The resource type
+     */
+    template<typename T>
+    struct ResourceTraits {
+        static constexpr bool has_sentinel = false;  ///< Whether T has a value meaning "no resource"
+    };
+
+    /**
+     * @brief Helper for ResourceTraits specializations whose sentinel is a constant expression
+     * 
+     * @tparam T The resource type
+     * @tparam Value The value that represents "no resource"
+     */
+    template<typename T, T Value>
+    struct SentinelTraits {
+        static constexpr bool has_sentinel = true;  ///< T has a value meaning "no resource"
+
+        /**
+         * @brief Returns the value that represents "no resource"
+         * @return The sentinel value
+         */
+        static constexpr T sentinel() noexcept { return Value; }
+    };
+
+    /**
+     * @brief Specialization for pointer types
+     * 
+     * Uses nullptr as the sentinel, matching the ValidityCheck specialization for pointers.
+     * 
+     * @tparam T The pointed-to type
+     */
+    template<typename T>
+    struct ResourceTraits<T*> : SentinelTraits<T*, nullptr> {};
+
+    /**
+     * @brief Trait marking types that can be moved to a new address with memcpy
+     * 
+     * A trivially relocatable object can be relocated by copying its bytes and forgetting the
+     * source, without running the move constructor and destructor. Defaults to true for
+     * trivially copyable types; guards and groups are relocatable when their resources and
+     * deleters are. Specialize it (as std::true_type) for handle or deleter types that own
+     * state but do not depend on their own address, e.g. types holding a unique pointer:
+     * 
+     * @code
+     * template<> struct resourceguard::is_trivially_relocatable<Connection> : std::true_type {};
+     * @endcode
+     * 
+     * Used by GuardVector to grow with memcpy/realloc instead of a per-element move loop.
+     * 
+     * @tparam T The type to check
+     */
+    template<typename T>
+    struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    namespace detail {
+
+        /**
+         * @brief Converts to T by constructing it from stored arguments
+         * 
+         * Passing an Emplacer where a T is expected constructs the T directly in its final
+         * location (guaranteed copy elision), so containers like std::tuple can be emplaced
+         * into without a temporary.
+         * 
+         * @tparam T The type to construct
+         * @tparam Args Reference types of the constructor arguments
+         */
+        template<typename T, typename... Args>
+        struct Emplacer {
+            std::tuple<Args...> args;
+
+            operator T() && {
+                return std::make_from_tuple<T>(std::move(args));
+            }
+        };
+
+        /**
+         * @brief Storage for a single object whose lifetime is managed by its owner
+         * 
+         * Constructs nothing by itself; the owner calls construct() and destroy() and tracks
+         * which slots are alive.
+         * 
+         * @tparam T The type of object to store
+         */
+        template<typename T>
+        struct ManualSlot {
+            union {
+                T value;  ///< The object, alive only between construct() and destroy()
+            };
+
+            ManualSlot() noexcept {}
+            ~ManualSlot() {}
+
+            template<typename... Args>
+            void construct(Args&&... args) {
+                ::new (static_cast<void*>(std::addressof(value))) T(std::forward<Args>(args)...);
+            }
+
+            void destroy() noexcept { value.~T(); }
+        };
+
+        /**
+         * @brief Storage for the managed resources that tracks release with a flag
+         * 
+         * The resources are destroyed in place on release and only constructed while owned,
+         * so resource types need not be default-constructible.
+         * 
+         * Used for multi-resource guards and for resource types without a sentinel.
+         * 
+         * @tparam Sentinel Whether the release state can be encoded in the resource itself
+         * @tparam Resources The types of resources to store
+         */
+        template<bool Sentinel, typename... Resources>
+        struct ResourceStorage {
+            using Tuple = std::tuple<Resources...>;
+
+            union {
+                Tuple resources;  ///< Tuple containing the managed resources, alive only while not released
+            };
+            bool released;        ///< Flag indicating if resources have been released
+
+            template<typename... Args>
+            explicit ResourceStorage(Args&&... args) : resources(std::forward<Args>(args)...), released(false) {}
+
+            ResourceStorage(ResourceStorage&& other) noexcept : released(other.released) {
+                if (!released) {
+                    ::new (static_cast<void*>(std::addressof(resources))) Tuple(std::move(other.resources));
+                    other.mark_released();
+                }
+            }
+
+            ResourceStorage& operator=(ResourceStorage&& other) noexcept {
+                mark_released();
+                if (!other.released) {
+                    ::new (static_cast<void*>(std::addressof(resources))) Tuple(std::move(other.resources));
+                    released = false;
+                    other.mark_released();
+                }
+                return *this;
+            }
+
+            ~ResourceStorage() { mark_released(); }
+
+            bool is_released() const noexcept { return released; }
+
+            void mark_released() noexcept {
+                if (!released) {
+                    resources.~Tuple();
+                    released = true;
+                }
+            }
+
+            Tuple take() noexcept {
+                Tuple out(std::move(resources));
+                mark_released();
+                return out;
+            }
+
+            template<typename... Args>
+            void assign(Args&&... args) {
+                mark_released();
+                ::new (static_cast<void*>(std::addressof(resources))) Tuple(std::forward<Args>(args)...);
+                released = false;
+            }
+
+            template<typename... Args>
+            void emplace(Args&&... args) {
+                static_assert(sizeof...(Resources) == 1, "emplace() requires a single resource");
+                assign(Emplacer<std::tuple_element_t<0, Tuple>, Args&&...>{
+                    std::forward_as_tuple(std::forward<Args>(args)...)});
+            }
+        };
+
+        /**
+         * @brief Storage for a single resource whose sentinel value doubles as the released state
+         * 
+         * @tparam Resource The type of resource to store
+         */
+        template<typename Resource>
+        struct ResourceStorage<true, Resource> {
+            using Traits = ResourceTraits<Resource>;
+
+            std::tuple<Resource> resources;  ///< Tuple containing the managed resource
+
+            template<typename... Args>
+            explicit ResourceStorage(Args&&... args) : resources(std::forward<Args>(args)...) {}
+
+            ResourceStorage(ResourceStorage&& other) noexcept
+                : resources(std::move(other.resources)) {
+                other.mark_released();
+            }
+
+            ResourceStorage& operator=(ResourceStorage&& other) noexcept {
+                resources = std::move(other.resources);
+                other.mark_released();
+                return *this;
+            }
+
+            bool is_released() const noexcept { return std::get<0>(resources) == Traits::sentinel(); }
+
+            void mark_released() noexcept { std::get<0>(resources) = Traits::sentinel(); }
+
+            std::tuple<Resource> take() noexcept {
+                std::tuple<Resource> out(std::move(resources));
+                mark_released();
+                return out;
+            }
+
+            template<typename Arg>
+            void assign(Arg&& arg) { std::get<0>(resources) = std::forward<Arg>(arg); }
+
+            template<typename... Args>
+            void emplace(Args&&... args) {
+                std::get<0>(resources) = Emplacer<Resource, Args&&...>{std::forward_as_tuple(std::forward<Args>(args)...)};
+            }
+        };
+
+        /**
+         * @brief Whether a guard over Resources can encode its released state in the resource itself
+         */
+        template<typename... Resources>
+        inline constexpr bool encodes_release_v = false;
+
+        template<typename Resource>
+        inline constexpr bool encodes_release_v<Resource> = ResourceTraits<Resource>::has_sentinel;
+
+        template<typename... Resources>
+        using ResourceStorageFor = ResourceStorage<encodes_release_v<Resources...>, Resources...>;
+
+        /**
+         * @brief Holds a deleter as a plain member
+         * 
+         * Used for deleters with state (e.g. capturing lambdas, function pointers) and final classes.
+         * 
+         * @tparam Deleter The deleter type to store
+         * @tparam Empty Whether the deleter can be stored as an empty base
+         */
+        template<typename Deleter, bool Empty = std::is_empty_v<Deleter> && !std::is_final_v<Deleter>>
+        class DeleterStorage {
+            Deleter m_deleter;  ///< Function object for resource cleanup
+
+        public:
+            template<typename D>
+            explicit DeleterStorage(D&& deleter) : m_deleter(std::forward<D>(deleter)) {}
+
+            Deleter& deleter() noexcept { return m_deleter; }
+            const Deleter& deleter() const noexcept { return m_deleter; }
+        };
+
+        /**
+         * @brief Holds a stateless deleter as an empty base so it occupies no storage
+         * 
+         * Moving between two instances is a no-op, which also makes guards over captureless
+         * lambdas move-assignable (closure types have no copy assignment before C++20).
+         * 
+         * @tparam Deleter The deleter type to store
+         */
+        template<typename Deleter>
+        class DeleterStorage<Deleter, true> : private Deleter {
+        public:
+            template<typename D>
+            explicit DeleterStorage(D&& deleter) : Deleter(std::forward<D>(deleter)) {}
+
+            DeleterStorage(DeleterStorage&& other) noexcept : Deleter(std::move(other.deleter())) {}
+            DeleterStorage& operator=(DeleterStorage&&) noexcept { return *this; }
+
+            Deleter& deleter() noexcept { return *this; }
+            const Deleter& deleter() const noexcept { return *this; }
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Deleter that calls a function known at compile time
+     * 
+     * The function is a non-type template parameter, so the deleter is stateless and the call
+     * is direct (and inlinable) instead of going through a stored function pointer.
+     * 
+     * @tparam Fn The cleanup function, e.g. `&fclose`, `&close` or `&free`
+     */
+    template<auto Fn>
+    struct FunctionDeleter {
+        /**
+         * @brief Invokes Fn with the resources, discarding its return value
+         * @param args The resources to clean up
+         */
+        template<typename... Args>
+        void operator()(Args&&... args) const noexcept(std::is_nothrow_invocable_v<decltype(Fn), Args...>) {
+            std::invoke(Fn, std::forward<Args>(args)...);
+        }
+    };
+
+    /**
+     * @brief Function called when a released guard is accessed and the policy cannot throw
+     * 
+     * The handler receives a description of the misuse. If it returns, the program is aborted.
+     */
+    using MisuseHandler = void (*)(const char* what);
+
+    namespace detail {
+
+        inline void default_misuse_handler(const char* what) {
+            std::fprintf(stderr, "ResourceGuard misuse: %s\n", what);
+        }
+
+        inline std::atomic<MisuseHandler> g_misuse_handler{&default_misuse_handler};
+
+        /**
+         * @brief Calls the installed misuse handler and aborts
+         * @param what Description of the misuse
+         */
+        [[noreturn]] inline void report_misuse(const char* what) noexcept {
+            g_misuse_handler.load(std::memory_order_acquire)(what);
+            std::abort();
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Installs the handler called on misuse by non-throwing check policies
+     * 
+     * @param handler The new handler, or nullptr to restore the default (print to stderr)
+     * @return The previously installed handler
+     */
+    inline MisuseHandler set_misuse_handler(MisuseHandler handler) noexcept {
+        return detail::g_misuse_handler.exchange(handler ? handler : &detail::default_misuse_handler,
+                                                 std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Record of a deleter that threw during cleanup
+     */
+    struct CleanupFailure {
+        const void* type_id;        ///< Identifies the deleter type, see type_id()
+        std::int64_t timestamp_ns;  ///< steady_clock time of the failure in nanoseconds
+        char error[64];             ///< Truncated what() of the exception, or "unknown exception"
+    };
+
+    /**
+     * @brief Function receiving cleanup failures; called on the destructor path, so it must not block
+     */
+    using CleanupFailureSink = void (*)(const CleanupFailure&) noexcept;
+
+    /**
+     * @brief Returns a value that uniquely identifies a type without requiring RTTI
+     * 
+     * @tparam T The type to identify
+     * @return An address unique to T
+     */
+    template<typename T>
+    const void* type_id() noexcept;
+
+    namespace detail {
+
+        template<typename T>
+        struct TypeTag {
+            static constexpr char id = 0;
+        };
+
+        /**
+         * @brief Per-thread single-producer ring of cleanup failures
+         * 
+         * The owning thread pushes without blocking; a full ring drops the record. Any thread
+         * may drain, drainers are serialized with a try-lock so they never wait on each other.
+         * Rings are never freed: when a thread exits its ring is handed to the next thread
+         * that needs one, so the number of rings is bounded by the peak thread count.
+         */
+        struct FailureRing {
+            static constexpr std::uint32_t capacity = 64;
+
+            CleanupFailure slots[capacity];
+            std::atomic<std::uint32_t> head{0};     ///< Next slot to write, owned by the producer
+            std::atomic<std::uint32_t> tail{0};     ///< Next slot to read, owned by the drainer
+            std::atomic<bool> owned{true};          ///< Whether a live thread produces into this ring
+            std::atomic<bool> draining{false};      ///< Drainer try-lock
+            FailureRing* next = nullptr;            ///< Next ring in the registry
+
+            bool push(const CleanupFailure& failure) noexcept {
+                std::uint32_t h = head.load(std::memory_order_relaxed);
+                if (h - tail.load(std::memory_order_acquire) == capacity) return false;
+                slots[h % capacity] = failure;
+                head.store(h + 1, std::memory_order_release);
+                return true;
+            }
+
+            template<typename Fn>
+            std::size_t drain(Fn& fn, std::size_t budget) {
+                if (budget == 0 || draining.exchange(true, std::memory_order_acquire)) return 0;
+                std::uint32_t t = tail.load(std::memory_order_relaxed);
+                std::uint32_t h = head.load(std::memory_order_acquire);
+                std::size_t drained = 0;
+                while (t != h && drained < budget) {
+                    CleanupFailure failure = slots[t % capacity];
+                    tail.store(++t, std::memory_order_release);
+                    ++drained;
+                    fn(static_cast<const CleanupFailure&>(failure));
+                }
+                draining.store(false, std::memory_order_release);
+                return drained;
+            }
+        };
+
+        inline std::atomic<FailureRing*> g_failure_rings{nullptr};
+        inline std::atomic<std::uint64_t> g_dropped_failures{0};
+
+        inline FailureRing* acquire_failure_ring() noexcept {
+            for (FailureRing* r = g_failure_rings.load(std::memory_order_acquire); r; r = r->next) {
+                bool expected = false;
+                if (!r->owned.load(std::memory_order_relaxed) &&
+                    r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    return r;
+                }
+            }
+            FailureRing* ring = new (std::nothrow) FailureRing;
+            if (!ring) return nullptr;
+            ring->next = g_failure_rings.load(std::memory_order_relaxed);
+            while (!g_failure_rings.compare_exchange_weak(ring->next, ring, std::memory_order_release,
+                                                          std::memory_order_relaxed)) {}
+            return ring;
+        }
+
+        /**
+         * @brief The calling thread's ring, or nullptr before first use and after thread exit
+         *
+         * Trivially destructible, so it can still be read while other thread-locals are
+         * destroyed at thread exit, in whatever order that happens.
+         */
+        inline thread_local FailureRing* t_failure_ring = nullptr;
+
+        /**
+         * @brief Set once the calling thread has given its ring up at thread exit
+         */
+        inline thread_local bool t_failure_ring_released = false;
+
+        struct FailureRingOwner {
+            FailureRing* ring = acquire_failure_ring();
+            FailureRingOwner() noexcept { t_failure_ring = ring; }
+            ~FailureRingOwner() {
+                t_failure_ring = nullptr;
+                t_failure_ring_released = true;
+                if (ring) ring->owned.store(false, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @brief Returns the calling thread's ring, or nullptr if it has none
+         *
+         * Once the ring has been given up at thread exit, another thread may have adopted it,
+         * so failures reported later (by deleters run from other thread-locals' destructors)
+         * get no ring and are counted as dropped.
+         */
+        inline FailureRing* thread_failure_ring() noexcept {
+            if (FailureRing* ring = t_failure_ring) return ring;
+            if (t_failure_ring_released) return nullptr;
+            thread_local FailureRingOwner owner;
+            return owner.ring;
+        }
+
+    } // namespace detail
+
+    template<typename T>
+    const void* type_id() noexcept { return &detail::TypeTag<T>::id; }
+
+    /**
+     * @brief Default sink: records the failure in the calling thread's lock-free ring
+     * 
+     * Records that do not fit, and records reported after the calling thread gave its ring up
+     * at thread exit, are counted, see dropped_cleanup_failures().
+     * 
+     * @param failure The failure to record
+     */
+    inline void record_cleanup_failure(const CleanupFailure& failure) noexcept {
+        detail::FailureRing* ring = detail::thread_failure_ring();
+        if (!ring || !ring->push(failure)) detail::g_dropped_failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sink that writes the failure to stderr immediately
+     * 
+     * Matches the historic behaviour; blocks on the stream, so avoid it on latency-critical threads.
+     * 
+     * @param failure The failure to print
+     */
+    inline void print_cleanup_failure(const CleanupFailure& failure) noexcept {
+        std::fprintf(stderr, "Cleanup error - potential leak: %s\n", failure.error);
+    }
+
+    namespace detail {
+
+        inline std::atomic<CleanupFailureSink> g_cleanup_failure_sink{&record_cleanup_failure};
+
+        template<typename Deleter, typename = void>
+        struct has_failure_sink : std::false_type {};
+
+        template<typename Deleter>
+        struct has_failure_sink<Deleter, std::void_t<decltype(
+            std::declval<Deleter&>().on_cleanup_failure(std::declval<const CleanupFailure&>()))>>
+            : std::true_type {};
+
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+        /**
+         * @brief Reports the exception currently being handled as a cleanup failure
+         * 
+         * Kept out of line and marked cold so the destructor fast path stays small. Must be
+         * called from within a catch block. A deleter with an `on_cleanup_failure(const
+         * CleanupFailure&)` member receives the failure instead of the global sink.
+         * 
+         * @param deleter The deleter that threw
+         */
+        template<typename Deleter>
+        RESOURCEGUARD_COLD void report_cleanup_failure(Deleter& deleter) noexcept {
+            CleanupFailure failure{};
+            failure.type_id = type_id<Deleter>();
+            failure.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            const char* what = "unknown exception";
+            try {
+                throw;
+            } catch (const std::exception& e) {
+                what = e.what();
+            } catch (...) {
+            }
+            std::strncpy(failure.error, what, sizeof(failure.error) - 1);
+
+            if constexpr (has_failure_sink<Deleter>::value) {
+                try {
+                    deleter.on_cleanup_failure(static_cast<const CleanupFailure&>(failure));
+                } catch (...) {
+                    record_cleanup_failure(failure);
+                }
+            } else {
+                g_cleanup_failure_sink.load(std::memory_order_acquire)(failure);
+            }
+        }
+#endif
+
+        /**
+         * @brief Invokes a deleter, reporting (not propagating) anything it throws
+         * 
+         * A deleter that is nothrow-invocable is called directly, without an exception handler.
+         * 
+         * @param deleter The deleter to invoke
+         * @param resources The resources to pass to it
+         */
+        template<typename Deleter, typename... Resources>
+        void invoke_deleter(Deleter& deleter, Resources&... resources) noexcept {
+            if constexpr (std::is_nothrow_invocable_v<Deleter&, Resources&...>) {
+                deleter(resources...);
+            } else {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+                try {
+                    deleter(resources...);
+                } catch (...) {
+                    report_cleanup_failure(deleter);
+                }
+#else
+                deleter(resources...);
+#endif
+            }
+        }
+
+        /**
+         * @brief Detects a batch deleter hook: `destroy_batch(T* handles, std::size_t count)`
+         */
+        template<typename Deleter, typename T, typename = void>
+        struct has_destroy_batch : std::false_type {};
+
+        template<typename Deleter, typename T>
+        struct has_destroy_batch<Deleter, T, std::void_t<decltype(
+            std::declval<Deleter&>().destroy_batch(std::declval<T*>(), std::size_t{}))>>
+            : std::true_type {};
+
+        /**
+         * @brief Invokes a deleter's batch hook, reporting (not propagating) anything it throws
+         * 
+         * @param deleter The deleter providing destroy_batch()
+         * @param handles The handles to clean up
+         * @param count The number of handles
+         */
+        template<typename Deleter, typename T>
+        void invoke_batch_deleter(Deleter& deleter, T* handles, std::size_t count) noexcept {
+            if constexpr (noexcept(deleter.destroy_batch(handles, count))) {
+                deleter.destroy_batch(handles, count);
+            } else {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+                try {
+                    deleter.destroy_batch(handles, count);
+                } catch (...) {
+                    report_cleanup_failure(deleter);
+                }
+#else
+                deleter.destroy_batch(handles, count);
+#endif
+            }
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Installs the global sink for cleanup failures
+     * 
+     * Guards whose deleter provides `on_cleanup_failure(const CleanupFailure&)` report there instead.
+     * 
+     * @param sink The new sink, or nullptr to restore the default (record_cleanup_failure)
+     * @return The previously installed sink
+     */
+    inline CleanupFailureSink set_cleanup_failure_sink(CleanupFailureSink sink) noexcept {
+        return detail::g_cleanup_failure_sink.exchange(sink ? sink : &record_cleanup_failure,
+                                                       std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Drains recorded cleanup failures from all threads' rings
+     * 
+     * Never blocks: rings currently drained by another thread are skipped.
+     * 
+     * @param fn Callable invoked with each `const CleanupFailure&`
+     * @param max_records Maximum number of records to drain in this call
+     * @return The number of records drained
+     */
+    template<typename Fn>
+    std::size_t drain_cleanup_failures(Fn&& fn, std::size_t max_records = SIZE_MAX) {
+        std::size_t drained = 0;
+        for (detail::FailureRing* r = detail::g_failure_rings.load(std::memory_order_acquire);
+             r && drained < max_records; r = r->next) {
+            drained += r->drain(fn, max_records - drained);
+        }
+        return drained;
+    }
+
+    /**
+     * @brief Returns the number of cleanup failures dropped because a ring was full or gone
+     * @return Total dropped records since program start
+     */
+    inline std::uint64_t dropped_cleanup_failures() noexcept {
+        return detail::g_dropped_failures.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @class CleanupFailureReporter
+     * @brief Rate-limited printer for recorded cleanup failures
+     * 
+     * Call poll() periodically (e.g. from a housekeeping timer). Each poll prints at most
+     * `burst` records and does nothing if called again within `interval`. Not thread-safe;
+     * use one reporter per draining thread.
+     */
+    class CleanupFailureReporter {
+        using Clock = std::chrono::steady_clock;
+
+        std::size_t m_burst;
+        Clock::duration m_interval;
+        std::FILE* m_out;
+        Clock::time_point m_last_poll{};
+        std::uint64_t m_dropped_seen = 0;
+        bool m_polled = false;
+
+    public:
+        /**
+         * @brief Constructs a reporter
+         * 
+         * @param burst Maximum records printed per poll
+         * @param interval Minimum time between two polls that print
+         * @param out Stream to print to
+         */
+        explicit CleanupFailureReporter(std::size_t burst = 16,
+                                        Clock::duration interval = std::chrono::seconds(1),
+                                        std::FILE* out = stderr)
+            : m_burst(burst), m_interval(interval), m_out(out) {}
+
+        /**
+         * @brief Prints pending failures if the interval has elapsed
+         * 
+         * @return The number of records printed
+         */
+        std::size_t poll() {
+            Clock::time_point now = Clock::now();
+            if (m_polled && now - m_last_poll < m_interval) return 0;
+            m_polled = true;
+            m_last_poll = now;
+
+            std::size_t printed = drain_cleanup_failures([this](const CleanupFailure& failure) {
+                std::fprintf(m_out, "Cleanup error - potential leak: %s\n", failure.error);
+            }, m_burst);
+
+            std::uint64_t dropped = dropped_cleanup_failures();
+            if (dropped != m_dropped_seen) {
+                std::fprintf(m_out, "Cleanup error - %llu failure records dropped\n",
+                             static_cast<unsigned long long>(dropped - m_dropped_seen));
+                m_dropped_seen = dropped;
+            }
+            return printed;
+        }
+    };
+
+    /**
+     * @brief Check policy that throws std::logic_error when a released guard is accessed
+     * 
+     * This is the default policy of ResourceGuard. When exceptions are disabled it reports
+     * through the misuse handler instead, like HandlerCheck.
+     */
+    struct ThrowingCheck {
+        static constexpr bool enabled = true;                                  ///< Accessors test the released state
+        static constexpr bool is_nothrow = !RESOURCEGUARD_HAS_EXCEPTIONS;      ///< Whether fail() never throws
+
+        /**
+         * @brief Reports access to a released guard
+         * @param what Description of the misuse
+         * @throws std::logic_error always (when exceptions are enabled)
+         */
+        [[noreturn]] static void fail(const char* what) noexcept(is_nothrow) {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            throw std::logic_error(what);
+#else
+            detail::report_misuse(what);
+#endif
+        }
+    };
+
+    /**
+     * @brief Check policy that reports access to a released guard through the misuse handler
+     * 
+     * Always checks, never throws; suitable for builds with exceptions disabled.
+     * See set_misuse_handler().
+     */
+    struct HandlerCheck {
+        static constexpr bool enabled = true;      ///< Accessors test the released state
+        static constexpr bool is_nothrow = true;   ///< fail() never throws
+
+        /**
+         * @brief Calls the misuse handler and aborts
+         * @param what Description of the misuse
+         */
+        [[noreturn]] static void fail(const char* what) noexcept { detail::report_misuse(what); }
+    };
+
+    /**
+     * @brief Check policy that reports access to a released guard in debug builds only
+     * 
+     * Misuse goes through the misuse handler and aborts. Like assert(), the check compiles away entirely when NDEBUG is defined.
+     */
+    struct AssertingCheck {
+#ifdef NDEBUG
+        static constexpr bool enabled = false;     ///< Accessors do not test the released state
+#else
+        static constexpr bool enabled = true;      ///< Accessors test the released state
+#endif
+        static constexpr bool is_nothrow = true;   ///< fail() never throws
+
+        /**
+         * @brief Reports access to a released guard and aborts
+         * @param what Description of the misuse
+         */
+        [[noreturn]] static void fail(const char* what) noexcept { detail::report_misuse(what); }
+    };
+
+    /**
+     * @brief Check policy that never tests the released state
+     * 
+     * Accessors compile to a plain load/store. Accessing a released guard is the caller's
+     * responsibility: a sentinel-encoded guard yields its sentinel, any other released guard
+     * no longer holds a live resource and must not be accessed.
+     */
+    struct NoCheck {
+        static constexpr bool enabled = false;     ///< Accessors do not test the released state
+        static constexpr bool is_nothrow = true;   ///< fail() never throws
+
+        /**
+         * @brief Never called
+         */
+        static void fail(const char*) noexcept {}
+    };
+
+#ifndef RESOURCEGUARD_DEFAULT_CHECK_POLICY
+    /**
+     * @brief Check policy used by ResourceGuard; define before including this header to override
+     */
+#define RESOURCEGUARD_DEFAULT_CHECK_POLICY ::resourceguard::ThrowingCheck
+#endif
+
+    /**
+     * @class BasicResourceGuard
+     * @brief RAII wrapper for managing one or more resources
+     * 
+     * BasicResourceGuard is a class template that manages the lifecycle of one or more resources.
+     * It ensures resources are properly cleaned up when the ResourceGuard instance goes out of scope
+     * or is explicitly released. The class supports move semantics but prevents copying to ensure
+     * clear ownership of resources.
+     * 
+     * A guard over a single resource whose ResourceTraits declare a sentinel (e.g. any pointer)
+     * stores no release flag: holding the sentinel value means the guard is released, so a guard
+     * constructed from a null pointer is empty and never invokes its deleter.
+     * 
+     * The CheckPolicy decides what get(), set() and steal() do when the guard has been released:
+     * ThrowingCheck throws std::logic_error, HandlerCheck calls the misuse handler and aborts,
+     * AssertingCheck does the same in debug builds only, NoCheck never checks. try_get(),
+     * try_set() and try_steal() always check and report through their return value.
+     * 
+     * The header compiles with exceptions disabled (-fno-exceptions); ThrowingCheck then behaves
+     * like HandlerCheck and a throwing deleter cannot be caught during cleanup.
+     * 
+     * @tparam CheckPolicy Policy for accessing a released guard (ThrowingCheck, AssertingCheck, NoCheck)
+     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename CheckPolicy, typename Deleter, typename... Resources>
+    class BasicResourceGuard : private detail::DeleterStorage<Deleter> {
+        using Tuple = std::tuple<Resources...>;
+        using DeleterBase = detail::DeleterStorage<Deleter>;
+
+        detail::ResourceStorageFor<Resources...> m_storage;  ///< Managed resources and their release state
+
+        /**
+         * @brief Cleans up resources if they haven't been released yet
+         * 
+         * Applies the deleter to the resources and marks them as released.
+         * Errors during cleanup are reported to the cleanup failure sink but don't propagate.
+         * A deleter that is nothrow-invocable is called directly, without an exception handler.
+         */
+        void cleanup() noexcept {
+            if (!m_storage.is_released()) {
+                std::apply([this](Resources&... resources) {
+                    detail::invoke_deleter(DeleterBase::deleter(), resources...);
+                }, m_storage.resources);
+                m_storage.mark_released();
+            }
+        }
+
+        /**
+         * @brief Reports misuse through the check policy if resources have been released
+         * 
+         * @param what Description of the misuse
+         */
+        void check_live(const char* what) const noexcept(CheckPolicy::is_nothrow) {
+            if constexpr (CheckPolicy::enabled) {
+                if (m_storage.is_released()) CheckPolicy::fail(what);
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructs a ResourceGuard with the specified deleter and resources
+         * 
+         * @tparam D Deleter type (deduced)
+         * @tparam Args Resource types (deduced)
+         * @param deleter The cleanup function to call when resources are released
+         * @param args The resources to manage
+         */
+        template<typename D, typename... Args>
+        explicit BasicResourceGuard(D&& deleter, Args&&... args)
+            : DeleterBase(std::forward<D>(deleter)),
+              m_storage(std::forward<Args>(args)...) {}
+
+        /**
+         * @brief Destructor, automatically cleans up resources if not already released
+         */
+        ~BasicResourceGuard() { cleanup(); }
+
+        /**
+         * @brief Move constructor
+         * 
+         * Transfers ownership of resources from another ResourceGuard
+         * 
+         * @param other The ResourceGuard to move from
+         */
+         BasicResourceGuard(BasicResourceGuard&& other) noexcept
+            : DeleterBase(static_cast<DeleterBase&&>(other)),
+              m_storage(std::move(other.m_storage)) {}
+
+        /**
+         * @brief Move assignment operator
+         * 
+         * Transfers ownership of resources from another ResourceGuard,
+         * cleaning up any resources this instance currently owns
+         * 
+         * @param other The ResourceGuard to move from
+         * @return Reference to this instance
+         */
+         BasicResourceGuard& operator=(BasicResourceGuard&& other) noexcept {
+            if (this != &other) {
+                cleanup();
+                DeleterBase::operator=(static_cast<DeleterBase&&>(other));
+                m_storage = std::move(other.m_storage);
+            }
+            return *this;
+        }
+        
+        /**
+         * @brief Accesses the first resource
+         * 
+         * @return Reference to the first resource
+         * @throws std::logic_error if resources have been released (ThrowingCheck)
+         */
+        decltype(auto) get() const noexcept(CheckPolicy::is_nothrow) {
+            check_live("Resource released");
+            return std::get<0>(m_storage.resources);
+        }
+
+        /**
+         * @brief Accesses a specific resource by index
+         * 
+         * @tparam I The index of the resource to access
+         * @return Reference to the specified resource
+         * @throws std::logic_error if resources have been released (ThrowingCheck)
+         */
+        template<size_t I>
+        decltype(auto) get() const noexcept(CheckPolicy::is_nothrow) {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            check_live("Resource released");
+            return std::get<I>(m_storage.resources);
+        }
+
+        /**
+         * @brief Safely attempts to access the first resource
+         * 
+         * @return An optional containing the resource if available, nullopt otherwise
+         */
+        std::optional<std::reference_wrapper<const std::tuple_element_t<0, Tuple>>> try_get() const {
+            if (m_storage.is_released()) return std::nullopt;
+            return std::cref(std::get<0>(m_storage.resources));
+        }
+
+        /**
+         * @brief Safely attempts to access a specific resource by index
+         * 
+         * @tparam I The index of the resource to access
+         * @return An optional containing the resource if available, nullopt otherwise
+         */
+        template <size_t I>
+        std::optional<std::reference_wrapper<const std::tuple_element_t<I, Tuple>>> try_get() const {
+            if (m_storage.is_released()) return std::nullopt;
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            return std::cref(std::get<I>(m_storage.resources));
+        }
+
+        /**
+         * @brief Sets or replaces the first resource
+         * 
+         * @param new_resource The new resource to manage
+         * @throws std::logic_error if resources have been released (ThrowingCheck)
+         * @throws std::invalid_argument if type doesn't match
+         */
+        void set(const std::tuple_element_t<0, Tuple>& new_resource) {
+            check_live("Resource released");
+            std::get<0>(m_storage.resources) = new_resource;
+        }
+
+        /**
+         * @brief Sets or replaces a specific resource by index
+         * 
+         * @tparam I The index of the resource to set
+         * @param new_resource The new resource to manage
+         * @throws std::logic_error if resources have been released (ThrowingCheck)
+         * @throws std::invalid_argument if type doesn't match
+         */
+        template <size_t I>
+        void set(const std::tuple_element_t<I, Tuple>& new_resource) {
+            check_live("Resource released");
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            std::get<I>(m_storage.resources) = new_resource;
+        }
+
+        /**
+         * @brief Tries to set or replace the first resource
+         * 
+         * This method attempts to set the first resource to the new resource provided.
+         * It returns 0 if the resource was successfully set, and 1 if the resources have been released.
+         * 
+         * @param new_resource The new resource to manage
+         * @return 0 if the resource was set successfully, 1 if resources have been released
+         */
+        int try_set(const std::tuple_element_t<0, Tuple>& new_resource) {
+            if (m_storage.is_released()) return 1;
+            std::get<0>(m_storage.resources) = new_resource;
+            return 0;
+        }
+
+        /**
+         * @brief Tries to set or replace a specific resource by index
+         * 
+         * This method attempts to set a specific resource at index `I` to the new resource provided.
+         * It returns 0 if the resource was successfully set, and 1 if the resources have been released.
+         * 
+         * @tparam I The index of the resource to set
+         * @param new_resource The new resource to manage
+         * @return 0 if the resource was set successfully, 1 if resources have been released
+         * @throws std::invalid_argument if index `I` is out of bounds
+         */
+        template <size_t I>
+        int try_set(const std::tuple_element_t<I, Tuple>& new_resource) {
+            if (m_storage.is_released()) return 1;
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            std::get<I>(m_storage.resources) = new_resource;
+            return 0;
+        }
+
+        /**
+         * @brief Sets or replaces the first resource, moving from the argument
+         * 
+         * @param new_resource The new resource to manage
+         * @throws std::logic_error if resources have been released (ThrowingCheck)
+         */
+        void set(std::tuple_element_t<0, Tuple>&& new_resource) {
+            check_live("Resource released");
+            std::get<0>(m_storage.resources) = std::move(new_resource);
+        }
+
+        /**
+         * @brief Sets or replaces a specific resource by index, moving from the argument
+         * 
+         * @tparam I The index of the resource to set
+         * @param new_resource The new resource to manage
+         * @throws std::logic_error if resources have been released (ThrowingCheck)
+         */
+        template <size_t I>
+        void set(std::tuple_element_t<I, Tuple>&& new_resource) {
+            check_live("Resource released");
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            std::get<I>(m_storage.resources) = std::move(new_resource);
+        }
+
+        /**
+         * @brief Tries to set or replace the first resource, moving from the argument
+         * 
+         * @param new_resource The new resource to manage
+         * @return 0 if the resource was set successfully, 1 if resources have been released
+         */
+        int try_set(std::tuple_element_t<0, Tuple>&& new_resource) {
+            if (m_storage.is_released()) return 1;
+            std::get<0>(m_storage.resources) = std::move(new_resource);
+            return 0;
+        }
+
+        /**
+         * @brief Tries to set or replace a specific resource by index, moving from the argument
+         * 
+         * @tparam I The index of the resource to set
+         * @param new_resource The new resource to manage
+         * @return 0 if the resource was set successfully, 1 if resources have been released
+         */
+        template <size_t I>
+        int try_set(std::tuple_element_t<I, Tuple>&& new_resource) {
+            if (m_storage.is_released()) return 1;
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            std::get<I>(m_storage.resources) = std::move(new_resource);
+            return 0;
+        }
+
+        /**
+         * @brief Checks if all resources are valid and have not been released
+         * 
+         * Uses the ValidityCheck trait for each resource type to determine validity
+         * 
+         * @return true if all resources are valid and not released, false otherwise
+         */
+        explicit operator bool() const {
+            return !m_storage.is_released() && std::apply([](const auto&... args) {
+                return (ValidityCheck<decltype(args)>::check(args) && ...);
+            }, m_storage.resources);
+        }
+
+        /**
+         * @brief Explicitly releases resources before destruction
+         * 
+         * Calls the deleter and marks resources as released
+         */
+        void release() noexcept { cleanup(); }
+
+        /**
+         * @brief Disposes of the current resources and takes ownership of new ones
+         * 
+         * Unlike set(), which overwrites a resource without cleaning it up, reset() runs the
+         * deleter on the current resources (unless already released) before taking the new
+         * ones. Works on released guards too. If constructing a new resource throws, the guard
+         * is left released.
+         * 
+         * @tparam Args Types of the new resources (deduced)
+         * @param args The new resources, one per managed resource
+         */
+        template<typename... Args>
+        void reset(Args&&... args) {
+            static_assert(sizeof...(Args) == sizeof...(Resources), "One value per resource required");
+            cleanup();
+            m_storage.assign(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Disposes of the current resource and constructs a new one from arguments
+         * 
+         * Single-resource counterpart of reset() that constructs the resource from constructor
+         * arguments instead of taking a finished value.
+         * 
+         * @tparam Args Constructor argument types (deduced)
+         * @param args Arguments to construct the new resource from
+         */
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            static_assert(sizeof...(Resources) == 1, "emplace() requires a single-resource guard, use reset()");
+            cleanup();
+            m_storage.emplace(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Reuses a released guard for new resources
+         * 
+         * Avoids destroying and re-creating the guard (and its deleter) in loops that
+         * repeatedly acquire the same kind of resource.
+         * 
+         * @tparam Args Types of the new resources (deduced)
+         * @param args The new resources, one per managed resource
+         * @return 0 if the guard was rearmed, 1 if it still owns resources (nothing changed)
+         */
+        template<typename... Args>
+        int rearm(Args&&... args) {
+            static_assert(sizeof...(Args) == sizeof...(Resources), "One value per resource required");
+            if (!m_storage.is_released()) return 1;
+            m_storage.assign(std::forward<Args>(args)...);
+            return 0;
+        }
+
+        /**
+         * @brief Transfers ownership of resources to caller
+         * 
+         * After calling steal(), the ResourceGuard no longer manages the resources,
+         * and the caller is responsible for cleanup
+         * 
+         * @return Tuple containing all resources
+         * @throws std::logic_error if resources have already been released (ThrowingCheck)
+         */
+        std::tuple<Resources...> steal() {
+            check_live("Already released");
+            return m_storage.take();
+        }
+
+        /**
+         * @brief Safely attempts to transfer ownership of resources to caller
+         * 
+         * Non-throwing counterpart of steal() for code built without exceptions.
+         * 
+         * @return An optional containing all resources if available, nullopt otherwise
+         */
+        std::optional<std::tuple<Resources...>> try_steal() noexcept {
+            if (m_storage.is_released()) return std::nullopt;
+            return m_storage.take();
+        }
+
+        /**
+         * @brief Copy constructor (deleted)
+         * 
+         * ResourceGuard doesn't support copying to ensure clear ownership semantics
+         */
+        BasicResourceGuard(const BasicResourceGuard&) = delete;
+        
+        /**
+         * @brief Copy assignment operator (deleted)
+         * 
+         * ResourceGuard doesn't support copying to ensure clear ownership semantics
+         */
+        BasicResourceGuard& operator=(const BasicResourceGuard&) = delete;
+    };
+
+    /**
+     * @brief ResourceGuard using the default check policy
+     * 
+     * The default is ThrowingCheck unless RESOURCEGUARD_DEFAULT_CHECK_POLICY is defined.
+     * 
+     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename Deleter, typename... Resources>
+    using ResourceGuard = BasicResourceGuard<RESOURCEGUARD_DEFAULT_CHECK_POLICY, Deleter, Resources...>;
+
+    /**
+     * @brief Helper function to create ResourceGuard instances with type deduction
+     * 
+     * This function template automatically deduces types for ResourceGuard creation,
+     * simplifying its usage with the correct template argument order (Deleter first, then Resources).
+     * 
+     * @tparam Deleter The type of deleter function/object
+     * @tparam Args The types of resources to manage
+     * @param deleter Function object that will be called to clean up resources
+     * @param args The resources to manage
+     * @return A ResourceGuard instance managing the given resources
+     * 
+     * @example
+     * // Example: Managing a FILE* resource
+     * auto file = make_scoped_ref(
+     *     [](FILE* f) { if(f) fclose(f); },
+     *     fopen("example.txt", "r")
+     * );
+     * 
+     * // Example: Managing multiple resources
+     * auto resources = make_scoped_ref(
+     *     [](void* p1, int* p2) { 
+     *         if (p1) free(p1); 
+     *         if (p2) delete p2; 
+     *     },
+     *     malloc(100),
+     *     new int(42)
+     * );
+     */
+    template<typename Deleter, typename... Args>
+    auto make_resource_guard(Deleter&& deleter, Args&&... args) {
+        return ResourceGuard<
+            std::decay_t<Deleter>,      // Deleter type first
+            std::decay_t<Args>...       // Resource types after
+        >(
+            std::forward<Deleter>(deleter),
+            std::forward<Args>(args)...
+        );
+    }
+
+    /**
+     * @brief Helper function to create BasicResourceGuard instances with an explicit check policy
+     * 
+     * @tparam CheckPolicy Policy for accessing a released guard
+     * @tparam Deleter The type of deleter function/object
+     * @tparam Args The types of resources to manage
+     * @param deleter Function object that will be called to clean up resources
+     * @param args The resources to manage
+     * @return A BasicResourceGuard instance managing the given resources
+     * 
+     * @example
+     * // Example: Unchecked access on a hot path
+     * auto buffer = make_basic_resource_guard<resourceguard::NoCheck>(
+     *     [](void* p) { free(p); },
+     *     malloc(4096)
+     * );
+     */
+    template<typename CheckPolicy, typename Deleter, typename... Args>
+    auto make_basic_resource_guard(Deleter&& deleter, Args&&... args) {
+        return BasicResourceGuard<
+            CheckPolicy,
+            std::decay_t<Deleter>,
+            std::decay_t<Args>...
+        >(
+            std::forward<Deleter>(deleter),
+            std::forward<Args>(args)...
+        );
+    }
+
+    /**
+     * @brief ResourceGuard whose deleter is a function known at compile time
+     * 
+     * @tparam Fn The cleanup function
+     * @tparam Resources The types of resources to manage
+     */
+    template<auto Fn, typename... Resources>
+    using FnResourceGuard = ResourceGuard<FunctionDeleter<Fn>, Resources...>;
+
+    /**
+     * @brief Helper function to create ResourceGuard instances with a compile-time deleter
+     * 
+     * The resulting guard stores only the resources and calls Fn directly on cleanup.
+     * 
+     * @tparam Fn The cleanup function
+     * @tparam Args The types of resources to manage
+     * @param args The resources to manage
+     * @return A FnResourceGuard instance managing the given resources
+     * 
+     * @example
+     * // Example: Managing a FILE* resource, sizeof(file) == sizeof(FILE*)
+     * auto file = make_resource_guard<&fclose>(fopen("example.txt", "r"));
+     */
+    template<auto Fn, typename... Args>
+    auto make_resource_guard(Args&&... args) {
+        return FnResourceGuard<Fn, std::decay_t<Args>...>(
+            FunctionDeleter<Fn>{},
+            std::forward<Args>(args)...
+        );
+    }
+
+    namespace detail {
+
         /**
-         * @brief Checks if a pointer reference is valid (non-null)
-         * @param p The pointer reference to check
-         * @return true if pointer is not null, false otherwise
+         * @brief Smallest unsigned integer with at least N bits, used as a per-slot liveness mask
          */
-        static bool check(T* const& p) { return p != nullptr; }
-    };
+        template<std::size_t N>
+        using SlotMask = std::conditional_t<N <= 8, std::uint8_t,
+                         std::conditional_t<N <= 16, std::uint16_t,
+                         std::conditional_t<N <= 32, std::uint32_t, std::uint64_t>>>;
+
+    } // namespace detail
+
+    template<typename CheckPolicy, typename DeleterTuple, typename... Resources>
+    class BasicResourceGroup;
 
     /**
-     * @class ResourceGuard
-     * @brief RAII wrapper for managing one or more resources
+     * @class BasicResourceGroup
+     * @brief RAII wrapper for several resources, each with its own deleter and lifetime
      * 
-     * ResourceGuard is a class template that manages the lifecycle of one or more resources.
-     * It ensures resources are properly cleaned up when the ResourceGuard instance goes out of scope
-     * or is explicitly released. The class supports move semantics but prevents copying to ensure
-     * clear ownership of resources.
+     * Unlike a multi-resource ResourceGuard, which applies one deleter to all resources at once,
+     * a resource group pairs every resource with its own deleter and tracks each slot separately.
+     * Individual resources can be released or stolen early with release<I>() and steal<I>();
+     * the remaining ones are released in reverse acquisition order (last resource first) by
+     * release() and the destructor.
      * 
-     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam CheckPolicy Policy for accessing a released slot (ThrowingCheck, AssertingCheck, NoCheck)
+     * @tparam Deleters The deleter types, one per resource
      * @tparam Resources The types of resources to manage
      */
-    template<typename Deleter, typename... Resources>
-    class ResourceGuard {
-        std::tuple<Resources...> m_resources;  ///< Tuple containing the managed resources
-        Deleter m_deleter;                     ///< Function object for resource cleanup
-        bool m_released = false;               ///< Flag indicating if resources have been released
+    template<typename CheckPolicy, typename... Deleters, typename... Resources>
+    class BasicResourceGroup<CheckPolicy, std::tuple<Deleters...>, Resources...>
+        : private detail::DeleterStorage<std::tuple<Deleters...>> {
+        static_assert(sizeof...(Deleters) == sizeof...(Resources), "One deleter per resource required");
+        static_assert(sizeof...(Resources) >= 1 && sizeof...(Resources) <= 64, "A group manages 1 to 64 resources");
+
+        using Tuple = std::tuple<Resources...>;
+        using DeleterBase = detail::DeleterStorage<std::tuple<Deleters...>>;
+        using Mask = detail::SlotMask<sizeof...(Resources)>;
+
+        static constexpr Mask all_live = static_cast<Mask>(~std::uint64_t(0) >> (64 - sizeof...(Resources)));
+
+        std::tuple<detail::ManualSlot<Resources>...> m_slots;  ///< Managed resources, alive while their bit is set
+        Mask m_live = 0;                                        ///< Bit I is set while resource I is owned
+
+        template<std::size_t I>
+        static constexpr Mask bit = static_cast<Mask>(Mask(1) << I);
+
+        template<std::size_t I>
+        std::tuple_element_t<I, Tuple>& slot() noexcept { return std::get<I>(m_slots).value; }
+
+        template<std::size_t I>
+        const std::tuple_element_t<I, Tuple>& slot() const noexcept { return std::get<I>(m_slots).value; }
+
+        template<std::size_t I, typename... Args>
+        void construct_slot(Args&&... args) {
+            std::get<I>(m_slots).construct(std::forward<Args>(args)...);
+            m_live |= bit<I>;
+        }
+
+        template<std::size_t I>
+        void destroy_slot() noexcept {
+            if (m_live & bit<I>) {
+                std::get<I>(m_slots).destroy();
+                m_live &= static_cast<Mask>(~bit<I>);
+            }
+        }
+
+        template<std::size_t... I, typename... Args>
+        void construct_all(std::index_sequence<I...>, Args&&... args) {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            try {
+                (construct_slot<I>(std::forward<Args>(args)), ...);
+            } catch (...) {
+                (destroy_slot<I>(), ...);
+                throw;
+            }
+#else
+            (construct_slot<I>(std::forward<Args>(args)), ...);
+#endif
+        }
+
+        template<std::size_t I>
+        void take_slot(BasicResourceGroup& other) noexcept {
+            if (other.m_live & bit<I>) {
+                construct_slot<I>(std::move(other.template slot<I>()));
+                other.template destroy_slot<I>();
+            }
+        }
+
+        template<std::size_t... I>
+        void take_all(BasicResourceGroup& other, std::index_sequence<I...>) noexcept {
+            (take_slot<I>(other), ...);
+        }
+
+        template<std::size_t... I>
+        Tuple steal_all(std::index_sequence<I...>) {
+            Tuple out(std::move(slot<I>())...);
+            (destroy_slot<I>(), ...);
+            return out;
+        }
+
+        template<std::size_t... I>
+        bool all_valid(std::index_sequence<I...>) const {
+            return (ValidityCheck<const Resources&>::check(slot<I>()) && ...);
+        }
 
         /**
-         * @brief Cleans up resources if they haven't been released yet
+         * @brief Cleans up resource I if it hasn't been released yet
          * 
-         * Applies the deleter to the resources and marks them as released.
-         * Errors during cleanup are logged to stderr but don't propagate.
+         * Runs deleter I and destroys the resource in place.
          */
-        void cleanup() noexcept {
-            if (!m_released) {
-                try {
-                    std::apply(m_deleter, m_resources);
-                } catch (...) {
-                    std::cerr << "Cleanup error - potential leak" << std::endl;
-                }
-                m_resources = {};
-                m_released = true;
+        template<std::size_t I>
+        void cleanup_slot() noexcept {
+            if (m_live & bit<I>) {
+                detail::invoke_deleter(std::get<I>(DeleterBase::deleter()), slot<I>());
+                destroy_slot<I>();
+            }
+        }
+
+        template<std::size_t... I>
+        void cleanup_reverse(std::index_sequence<I...>) noexcept {
+            (cleanup_slot<sizeof...(Resources) - 1 - I>(), ...);
+        }
+
+        void cleanup() noexcept { cleanup_reverse(std::index_sequence_for<Resources...>{}); }
+
+        /**
+         * @brief Reports misuse through the check policy if resource I has been released
+         * 
+         * @param what Description of the misuse
+         */
+        template<std::size_t I>
+        void check_live(const char* what) const noexcept(CheckPolicy::is_nothrow) {
+            if constexpr (CheckPolicy::enabled) {
+                if (!(m_live & bit<I>)) CheckPolicy::fail(what);
             }
         }
 
     public:
         /**
-         * @brief Constructs a ResourceGuard with the specified deleter and resources
+         * @brief Constructs a resource group from one deleter per resource and the resources
          * 
-         * @tparam D Deleter type (deduced)
          * @tparam Args Resource types (deduced)
-         * @param deleter The cleanup function to call when resources are released
+         * @param deleters Tuple of deleters; deleter I cleans up resource I
          * @param args The resources to manage
          */
-        template<typename D, typename... Args>
-        explicit ResourceGuard(D&& deleter, Args&&... args)
-            : m_deleter(std::forward<D>(deleter)),
-              m_resources(std::forward<Args>(args)...) {}
+        template<typename... Args>
+        explicit BasicResourceGroup(std::tuple<Deleters...> deleters, Args&&... args)
+            : DeleterBase(std::move(deleters)) {
+            static_assert(sizeof...(Args) == sizeof...(Resources), "One value per resource required");
+            construct_all(std::index_sequence_for<Resources...>{}, std::forward<Args>(args)...);
+        }
 
         /**
-         * @brief Destructor, automatically cleans up resources if not already released
+         * @brief Destructor, cleans up the remaining resources in reverse order
          */
-        ~ResourceGuard() { cleanup(); }
+        ~BasicResourceGroup() { cleanup(); }
 
         /**
          * @brief Move constructor
          * 
-         * Transfers ownership of resources from another ResourceGuard
-         * 
-         * @param other The ResourceGuard to move from
+         * @param other The BasicResourceGroup to move from
          */
-         ResourceGuard(ResourceGuard&& other) noexcept
-            : m_resources(std::move(other.m_resources)),
-              m_deleter(std::move(other.m_deleter)),
-              m_released(other.m_released) {
-            other.m_released = true;
+        BasicResourceGroup(BasicResourceGroup&& other) noexcept
+            : DeleterBase(static_cast<DeleterBase&&>(other)) {
+            take_all(other, std::index_sequence_for<Resources...>{});
         }
 
         /**
          * @brief Move assignment operator
          * 
-         * Transfers ownership of resources from another ResourceGuard,
-         * cleaning up any resources this instance currently owns
+         * Cleans up the resources this instance currently owns first
          * 
-         * @param other The ResourceGuard to move from
+         * @param other The BasicResourceGroup to move from
          * @return Reference to this instance
          */
-         ResourceGuard& operator=(ResourceGuard&& other) noexcept {
+        BasicResourceGroup& operator=(BasicResourceGroup&& other) noexcept {
             if (this != &other) {
                 cleanup();
-                m_resources = std::move(other.m_resources);
-                m_deleter = std::move(other.m_deleter);
-                m_released = other.m_released;
-                other.m_released = true;
+                DeleterBase::operator=(static_cast<DeleterBase&&>(other));
+                take_all(other, std::index_sequence_for<Resources...>{});
             }
             return *this;
         }
-        
-        /**
-         * @brief Accesses the first resource
-         * 
-         * @return Reference to the first resource
-         * @throws std::logic_error if resources have been released
-         */
-        decltype(auto) get() const {
-            if (m_released) throw std::logic_error("Resource released");
-            return std::get<0>(m_resources);
-        }
 
         /**
          * @brief Accesses a specific resource by index
          * 
          * @tparam I The index of the resource to access
          * @return Reference to the specified resource
-         * @throws std::logic_error if resources have been released
+         * @throws std::logic_error if the resource has been released (ThrowingCheck)
          */
-        template<size_t I>
-        decltype(auto) get() const {
+        template<std::size_t I = 0>
+        decltype(auto) get() const noexcept(CheckPolicy::is_nothrow) {
             static_assert(I < sizeof...(Resources), "Invalid resource index");
-            if (m_released) throw std::logic_error("Resource released");
-            return std::get<I>(m_resources);
+            check_live<I>("Resource released");
+            return slot<I>();
         }
 
         /**
-         * @brief Safely attempts to access the first resource
+         * @brief Safely attempts to access a specific resource by index
          * 
+         * @tparam I The index of the resource to access
          * @return An optional containing the resource if available, nullopt otherwise
          */
-        std::optional<std::reference_wrapper<const std::tuple_element_t<0, decltype(m_resources)>>> try_get() const {
-            if (m_released) return std::nullopt;
-            return std::cref(std::get<0>(m_resources));
+        template<std::size_t I = 0>
+        std::optional<std::reference_wrapper<const std::tuple_element_t<I, Tuple>>> try_get() const {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            if (!(m_live & bit<I>)) return std::nullopt;
+            return std::cref(slot<I>());
         }
 
         /**
-         * @brief Safely attempts to access a specific resource by index
+         * @brief Sets or replaces a specific resource by index
          * 
-         * @tparam I The index of the resource to access
-         * @return An optional containing the resource if available, nullopt otherwise
+         * @tparam I The index of the resource to set
+         * @param new_resource The new resource to manage
+         * @throws std::logic_error if the resource has been released (ThrowingCheck)
          */
-        template <size_t I>
-        std::optional<std::reference_wrapper<const std::tuple_element_t<I, decltype(m_resources)>>> try_get() const {
-            if (m_released) return std::nullopt;
+        template<std::size_t I = 0>
+        void set(const std::tuple_element_t<I, Tuple>& new_resource) {
             static_assert(I < sizeof...(Resources), "Invalid resource index");
-            return std::cref(std::get<I>(m_resources));
+            check_live<I>("Resource released");
+            slot<I>() = new_resource;
         }
 
         /**
-         * @brief Sets or replaces the first resource
+         * @brief Tries to set or replace a specific resource by index
          * 
+         * @tparam I The index of the resource to set
          * @param new_resource The new resource to manage
-         * @throws std::logic_error if resources have been released
-         * @throws std::invalid_argument if type doesn't match
+         * @return 0 if the resource was set successfully, 1 if it has been released
          */
-        void set(const std::tuple_element_t<0, decltype(m_resources)>& new_resource) {
-            if (m_released) throw std::logic_error("Resource released");
-            std::get<0>(m_resources) = new_resource;
+        template<std::size_t I = 0>
+        int try_set(const std::tuple_element_t<I, Tuple>& new_resource) {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            if (!(m_live & bit<I>)) return 1;
+            slot<I>() = new_resource;
+            return 0;
         }
 
         /**
-         * @brief Sets or replaces a specific resource by index
+         * @brief Sets or replaces a specific resource by index, moving from the argument
          * 
          * @tparam I The index of the resource to set
          * @param new_resource The new resource to manage
-         * @throws std::logic_error if resources have been released
-         * @throws std::invalid_argument if type doesn't match
+         * @throws std::logic_error if the resource has been released (ThrowingCheck)
          */
-        template <size_t I>
-        void set(const std::tuple_element_t<I, decltype(m_resources)>& new_resource) {
-            if (m_released) throw std::logic_error("Resource released");
+        template<std::size_t I = 0>
+        void set(std::tuple_element_t<I, Tuple>&& new_resource) {
             static_assert(I < sizeof...(Resources), "Invalid resource index");
-            std::get<I>(m_resources) = new_resource;
+            check_live<I>("Resource released");
+            slot<I>() = std::move(new_resource);
         }
 
         /**
-         * @brief Tries to set or replace the first resource
-         * 
-         * This method attempts to set the first resource to the new resource provided.
-         * It returns 0 if the resource was successfully set, and 1 if the resources have been released.
+         * @brief Tries to set or replace a specific resource by index, moving from the argument
          * 
+         * @tparam I The index of the resource to set
          * @param new_resource The new resource to manage
-         * @return 0 if the resource was set successfully, 1 if resources have been released
+         * @return 0 if the resource was set successfully, 1 if it has been released
          */
-        int try_set(const std::tuple_element_t<0, decltype(m_resources)>& new_resource) {
-            if (m_released) return 1;
-            std::get<0>(m_resources) = new_resource;
+        template<std::size_t I = 0>
+        int try_set(std::tuple_element_t<I, Tuple>&& new_resource) {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            if (!(m_live & bit<I>)) return 1;
+            slot<I>() = std::move(new_resource);
             return 0;
         }
 
         /**
-         * @brief Tries to set or replace a specific resource by index
+         * @brief Disposes of a specific resource and constructs a new one from arguments
          * 
-         * This method attempts to set a specific resource at index `I` to the new resource provided.
-         * It returns 0 if the resource was successfully set, and 1 if the resources have been released.
+         * Runs deleter I on the current resource (unless already released), then constructs the
+         * new resource in place and marks the slot owned again. Other slots are left untouched.
          * 
-         * @tparam I The index of the resource to set
-         * @param new_resource The new resource to manage
-         * @return 0 if the resource was set successfully, 1 if resources have been released
-         * @throws std::invalid_argument if index `I` is out of bounds
+         * @tparam I The index of the resource to replace
+         * @tparam Args Constructor argument types (deduced)
+         * @param args Arguments to construct the new resource from
          */
-        template <size_t I>
-        int try_set(const std::tuple_element_t<I, decltype(m_resources)>& new_resource) {
-            if (m_released) return 1;
+        template<std::size_t I, typename... Args>
+        void emplace(Args&&... args) {
             static_assert(I < sizeof...(Resources), "Invalid resource index");
-            std::get<I>(m_resources) = new_resource;
-            return 0;
+            cleanup_slot<I>();
+            construct_slot<I>(std::forward<Args>(args)...);
         }
 
         /**
-         * @brief Checks if all resources are valid and have not been released
+         * @brief Accesses the deleters
          * 
-         * Uses the ValidityCheck trait for each resource type to determine validity
+         * @return Reference to the tuple of deleters
+         */
+        std::tuple<Deleters...>& get_deleters() noexcept { return DeleterBase::deleter(); }
+
+        /**
+         * @brief Accesses the deleters
          * 
-         * @return true if all resources are valid and not released, false otherwise
+         * @return Reference to the tuple of deleters
          */
-        explicit operator bool() const {
-            return !m_released && std::apply([](const auto&... args) {
-                return (ValidityCheck<decltype(args)>::check(args) && ...);
-            }, m_resources);
+        const std::tuple<Deleters...>& get_deleters() const noexcept { return DeleterBase::deleter(); }
+
+        /**
+         * @brief Checks whether a specific resource is still owned
+         * 
+         * @tparam I The index of the resource
+         * @return true if resource I has been neither released nor stolen
+         */
+        template<std::size_t I>
+        bool owns() const noexcept {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            return (m_live & bit<I>) != 0;
         }
 
         /**
-         * @brief Explicitly releases resources before destruction
+         * @brief Checks if all resources are valid and none have been released
          * 
-         * Calls the deleter and marks resources as released
+         * @return true if all resources are owned and pass their ValidityCheck, false otherwise
+         */
+        explicit operator bool() const {
+            return m_live == all_live && all_valid(std::index_sequence_for<Resources...>{});
+        }
+
+        /**
+         * @brief Releases all remaining resources in reverse order
          */
         void release() noexcept { cleanup(); }
 
         /**
-         * @brief Transfers ownership of resources to caller
+         * @brief Releases a single resource early, leaving the others owned
          * 
-         * After calling steal(), the ResourceGuard no longer manages the resources,
-         * and the caller is responsible for cleanup
+         * Does nothing if the resource has already been released.
+         * 
+         * @tparam I The index of the resource to release
+         */
+        template<std::size_t I>
+        void release() noexcept {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            cleanup_slot<I>();
+        }
+
+        /**
+         * @brief Transfers ownership of a single resource to caller
+         * 
+         * @tparam I The index of the resource to steal
+         * @return The resource
+         * @throws std::logic_error if the resource has already been released (ThrowingCheck)
+         */
+        template<std::size_t I>
+        std::tuple_element_t<I, Tuple> steal() {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            check_live<I>("Already released");
+            std::tuple_element_t<I, Tuple> out(std::move(slot<I>()));
+            destroy_slot<I>();
+            return out;
+        }
+
+        /**
+         * @brief Transfers ownership of all resources to caller
          * 
          * @return Tuple containing all resources
-         * @throws std::logic_error if resources have already been released
+         * @throws std::logic_error if any resource has already been released (ThrowingCheck)
          */
-        std::tuple<Resources...> steal() {
-            if (m_released) throw std::logic_error("Already released");
-            m_released = true;
-            return std::move(m_resources);
+        Tuple steal() {
+            if constexpr (CheckPolicy::enabled) {
+                if (m_live != all_live) CheckPolicy::fail("Already released");
+            }
+            return steal_all(std::index_sequence_for<Resources...>{});
         }
 
         /**
          * @brief Copy constructor (deleted)
-         * 
-         * ResourceGuard doesn't support copying to ensure clear ownership semantics
          */
-        ResourceGuard(const ResourceGuard&) = delete;
-        
+        BasicResourceGroup(const BasicResourceGroup&) = delete;
+
         /**
          * @brief Copy assignment operator (deleted)
-         * 
-         * ResourceGuard doesn't support copying to ensure clear ownership semantics
          */
-        ResourceGuard& operator=(const ResourceGuard&) = delete;
+        BasicResourceGroup& operator=(const BasicResourceGroup&) = delete;
     };
 
     /**
-     * @brief Helper function to create ResourceGuard instances with type deduction
+     * @brief BasicResourceGroup using the default check policy
      * 
-     * This function template automatically deduces types for ResourceGuard creation,
-     * simplifying its usage with the correct template argument order (Deleter first, then Resources).
+     * @tparam DeleterTuple std::tuple of the deleter types, one per resource
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename DeleterTuple, typename... Resources>
+    using ResourceGroup = BasicResourceGroup<RESOURCEGUARD_DEFAULT_CHECK_POLICY, DeleterTuple, Resources...>;
+
+    /**
+     * @brief Guards relocate by memcpy when their deleter and resources do
      * 
-     * @tparam Deleter The type of deleter function/object
+     * Moving a guard only transfers the deleter and resources and marks the source released,
+     * so copying the bytes and skipping the source's destructor is equivalent.
+     */
+    template<typename CheckPolicy, typename Deleter, typename... Resources>
+    struct is_trivially_relocatable<BasicResourceGuard<CheckPolicy, Deleter, Resources...>>
+        : std::bool_constant<is_trivially_relocatable_v<Deleter> && (is_trivially_relocatable_v<Resources> && ...)> {};
+
+    /**
+     * @brief Groups relocate by memcpy when all their deleters and resources do
+     */
+    template<typename CheckPolicy, typename... Deleters, typename... Resources>
+    struct is_trivially_relocatable<BasicResourceGroup<CheckPolicy, std::tuple<Deleters...>, Resources...>>
+        : std::bool_constant<(is_trivially_relocatable_v<Deleters> && ...) &&
+                             (is_trivially_relocatable_v<Resources> && ...)> {};
+
+    /**
+     * @brief Helper function to create ResourceGroup instances with type deduction
+     * 
+     * @tparam Deleters The deleter types, one per resource
      * @tparam Args The types of resources to manage
-     * @param deleter Function object that will be called to clean up resources
+     * @param deleters Tuple of deleters; deleter I cleans up resource I
      * @param args The resources to manage
-     * @return A ResourceGuard instance managing the given resources
+     * @return A ResourceGroup instance managing the given resources
      * 
      * @example
-     * // Example: Managing a FILE* resource
-     * auto file = make_scoped_ref(
-     *     [](FILE* f) { if(f) fclose(f); },
-     *     fopen("example.txt", "r")
-     * );
-     * 
-     * // Example: Managing multiple resources
-     * auto resources = make_scoped_ref(
-     *     [](void* p1, int* p2) { 
-     *         if (p1) free(p1); 
-     *         if (p2) delete p2; 
-     *     },
-     *     malloc(100),
-     *     new int(42)
+     * // Example: Free a large buffer as soon as it is no longer needed
+     * auto io = make_resource_group(
+     *     std::make_tuple([](FILE* f) { fclose(f); }, [](void* p) { free(p); }),
+     *     fopen("example.txt", "r"),
+     *     malloc(1 << 20)
      * );
+     * // ... fill the file from the buffer ...
+     * io.release<1>();  // buffer freed now, file still open
      */
-    template<typename Deleter, typename... Args>
-    auto make_resource_guard(Deleter&& deleter, Args&&... args) {
-        return ResourceGuard<
-            std::decay_t<Deleter>,      // Deleter type first
-            std::decay_t<Args>...       // Resource types after
-        >(
-            std::forward<Deleter>(deleter),
+    template<typename... Deleters, typename... Args>
+    auto make_resource_group(std::tuple<Deleters...> deleters, Args&&... args) {
+        return ResourceGroup<std::tuple<Deleters...>, std::decay_t<Args>...>(
+            std::move(deleters),
             std::forward<Args>(args)...
         );
     }
 
+    namespace detail {
+
+        template<typename T>
+        struct AcquiredType {
+            using type = std::decay_t<T>;
+        };
+
+        template<typename T>
+        struct AcquiredType<std::optional<T>> {
+            using type = T;
+        };
+
+        /**
+         * @brief Resource type produced by an acquirer returning T (unwraps std::optional)
+         */
+        template<typename T>
+        using acquired_t = typename AcquiredType<std::decay_t<T>>::type;
+
+        /**
+         * @brief Checks whether an acquirer result denotes a successfully acquired resource
+         * 
+         * An empty optional, a sentinel value (see ResourceTraits) or a value failing its
+         * ValidityCheck all mean the acquisition failed.
+         */
+        template<typename T>
+        bool acquired(const T& result) {
+            if constexpr (ResourceTraits<T>::has_sentinel) {
+                if (result == ResourceTraits<T>::sentinel()) return false;
+            }
+            return ValidityCheck<T>::check(result);
+        }
+
+        template<typename T>
+        bool acquired(const std::optional<T>& result) {
+            return result.has_value() && acquired(*result);
+        }
+
+        template<typename T>
+        T&& unwrap_acquired(T&& result) noexcept { return std::forward<T>(result); }
+
+        template<typename T>
+        T&& unwrap_acquired(std::optional<T>&& result) noexcept { return std::move(*result); }
+
+        /**
+         * @brief Result type of an acquirer, called with the resources acquired so far if it accepts them
+         */
+        template<typename Acquirer, typename... Resources>
+        using acquirer_result_t = typename std::conditional_t<
+            std::is_invocable_v<Acquirer&, const Resources&...>,
+            std::invoke_result<Acquirer&, const Resources&...>,
+            std::invoke_result<Acquirer&>>::type;
+
+        template<typename DeleterTuple, typename... Resources>
+        using PartialGroup = std::conditional_t<sizeof...(Resources) == 0, std::tuple<>,
+                                                ResourceGroup<DeleterTuple, Resources...>>;
+
+    } // namespace detail
+
+    /**
+     * @class Acquisition
+     * @brief Builder that acquires resources one by one and rolls back on failure
+     * 
+     * Each acquire() step calls an acquirer and, on success, adds the result and its deleter
+     * to the resources acquired so far. If an acquirer fails (returns an empty optional, a
+     * sentinel value or an invalid resource) or throws, every resource acquired so far is
+     * released in reverse order and the remaining steps are skipped. commit() yields the
+     * ResourceGroup owning everything. No heap allocation is performed.
+     * 
+     * An acquirer is called with the resources acquired so far if it accepts them, otherwise
+     * with no arguments.
+     * 
+     * @tparam DeleterTuple std::tuple of the deleters of the resources acquired so far
+     * @tparam Resources The types of the resources acquired so far
+     * 
+     * @example
+     * auto conn = resourceguard::acquisition()
+     *     .acquire([] { return fopen("in.txt", "r"); }, &fclose)
+     *     .acquire([] { return fopen("out.txt", "w"); }, &fclose)
+     *     .acquire([](FILE*, FILE*) { return malloc(1 << 16); }, &free)
+     *     .commit();
+     * if (!conn) return;  // nothing leaked
+     * FILE* in = conn->get<0>();
+     */
+    template<typename DeleterTuple, typename... Resources>
+    class Acquisition;
+
+    template<typename... Deleters, typename... Resources>
+    class Acquisition<std::tuple<Deleters...>, Resources...> {
+        template<typename, typename...>
+        friend class Acquisition;
+
+        using Group = detail::PartialGroup<std::tuple<Deleters...>, Resources...>;
+
+        std::optional<Group> m_group;  ///< Resources acquired so far; empty once a step has failed
+
+        Acquisition() = default;
+
+        explicit Acquisition(Group&& group) : m_group(std::move(group)) {}
+
+        template<typename Acquirer, std::size_t... I>
+        auto call(Acquirer& acquirer, std::index_sequence<I...>) {
+            if constexpr (std::is_invocable_v<Acquirer&, const Resources&...>) {
+                return std::invoke(acquirer, m_group->template get<I>()...);
+            } else {
+                return std::invoke(acquirer);
+            }
+        }
+
+        friend Acquisition<std::tuple<>> acquisition();
+
+    public:
+        /**
+         * @brief Acquires the next resource
+         * 
+         * @tparam Acquirer Callable returning the resource or an std::optional of it
+         * @tparam Deleter Deleter type for the resource (deduced)
+         * @param acquirer Function that acquires the resource
+         * @param deleter Function object that will be called to clean up the resource
+         * @return The builder extended by the new resource; failed if this or an earlier step failed
+         */
+        template<typename Acquirer, typename Deleter>
+        auto acquire(Acquirer&& acquirer, Deleter&& deleter) && {
+            using Result = detail::acquirer_result_t<std::decay_t<Acquirer>, Resources...>;
+            using Next = Acquisition<std::tuple<Deleters..., std::decay_t<Deleter>>,
+                                     Resources..., detail::acquired_t<Result>>;
+
+            if (!m_group) return Next{};
+
+            std::decay_t<Acquirer> fn(std::forward<Acquirer>(acquirer));
+            auto result = call(fn, std::index_sequence_for<Resources...>{});
+            if (!detail::acquired(result)) {
+                m_group.reset();
+                return Next{};
+            }
+
+            if constexpr (sizeof...(Resources) == 0) {
+                return Next(typename Next::Group(
+                    std::make_tuple(std::forward<Deleter>(deleter)),
+                    detail::unwrap_acquired(std::move(result))));
+            } else {
+                auto deleters = std::tuple_cat(std::move(m_group->get_deleters()),
+                                               std::make_tuple(std::forward<Deleter>(deleter)));
+                auto resources = m_group->steal();
+                m_group.reset();
+                return Next(std::apply([&](Resources&... acquired) {
+                    return typename Next::Group(std::move(deleters), std::move(acquired)...,
+                                                detail::unwrap_acquired(std::move(result)));
+                }, resources));
+            }
+        }
+
+        /**
+         * @brief Checks whether all steps so far succeeded
+         * 
+         * @return true if no step has failed
+         */
+        explicit operator bool() const noexcept { return m_group.has_value(); }
+
+        /**
+         * @brief Finishes the acquisition
+         * 
+         * @return The ResourceGroup owning all resources, or nullopt if any step failed
+         */
+        std::optional<Group> commit() && {
+            static_assert(sizeof...(Resources) >= 1, "Nothing to commit");
+            return std::move(m_group);
+        }
+    };
+
+    /**
+     * @brief Starts a transactional acquisition
+     * 
+     * @return An empty Acquisition builder
+     */
+    inline Acquisition<std::tuple<>> acquisition() {
+        Acquisition<std::tuple<>> builder;
+        builder.m_group.emplace();
+        return builder;
+    }
+
 } // namespace ResourceGuard
\ No newline at end of file
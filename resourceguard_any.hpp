@@ -0,0 +1,232 @@
+#pragma once
+
+#include "resourceguard.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief Operations of a type-erased guard
+         */
+        struct AnyGuardVTable {
+            void (*destroy)(void* storage) noexcept;            ///< Destroys the guard, cleaning up its resources
+            void (*move)(void* dst, void* src) noexcept;        ///< Moves the guard to dst and destroys the source
+            void (*release)(void* storage);                     ///< Calls release() on the guard
+            bool (*valid)(const void* storage);                 ///< Calls operator bool on the guard
+            bool is_inline;                                     ///< Whether the guard lives in the inline buffer
+        };
+
+        /**
+         * @brief VTable for a guard stored in the inline buffer
+         */
+        template<typename Guard>
+        struct InlineGuardOps {
+            static Guard& get(void* storage) noexcept { return *std::launder(static_cast<Guard*>(storage)); }
+            static const Guard& get(const void* storage) noexcept {
+                return *std::launder(static_cast<const Guard*>(storage));
+            }
+
+            static void destroy(void* storage) noexcept { get(storage).~Guard(); }
+            static void move(void* dst, void* src) noexcept {
+                ::new (dst) Guard(std::move(get(src)));
+                get(src).~Guard();
+            }
+            static void release(void* storage) { get(storage).release(); }
+            static bool valid(const void* storage) { return static_cast<bool>(get(storage)); }
+
+            static constexpr AnyGuardVTable vtable = { &destroy, &move, &release, &valid, true };
+        };
+
+        /**
+         * @brief VTable for a guard too large for the inline buffer, which holds a pointer to it
+         */
+        template<typename Guard>
+        struct HeapGuardOps {
+            static Guard*& get(void* storage) noexcept { return *std::launder(static_cast<Guard**>(storage)); }
+            static Guard* get(const void* storage) noexcept {
+                return *std::launder(static_cast<Guard* const*>(storage));
+            }
+
+            static void destroy(void* storage) noexcept { delete get(storage); }
+            static void move(void* dst, void* src) noexcept { ::new (dst) Guard*(get(src)); }
+            static void release(void* storage) { get(storage)->release(); }
+            static bool valid(const void* storage) { return static_cast<bool>(*get(storage)); }
+
+            static constexpr AnyGuardVTable vtable = { &destroy, &move, &release, &valid, false };
+        };
+
+    } // namespace detail
+
+    /**
+     * @class AnyResourceGuard
+     * @brief Type-erased owner of any guard, stored inline when it fits
+     *
+     * Holds a ResourceGuard (or ResourceGroup, or any movable RAII type with release() and
+     * operator bool) of arbitrary deleter and resource types, so heterogeneous guards can share
+     * one container. Guards up to InlineSize bytes that are nothrow movable are stored in an
+     * inline buffer; larger ones are allocated on the heap. Dispatch goes through a static
+     * per-type table of function pointers, with no virtual base class.
+     *
+     * @code
+     * std::vector<resourceguard::AnyResourceGuard<>> teardown;
+     * teardown.emplace_back(resourceguard::make_resource_guard<&fclose>(fopen("a.txt", "r")));
+     * teardown.emplace_back(resourceguard::make_resource_guard<&close>(open("b.txt", O_RDONLY)));
+     * @endcode
+     *
+     * @tparam InlineSize Size of the inline buffer in bytes
+     */
+    template<std::size_t InlineSize = 32>
+    class AnyResourceGuard {
+        static_assert(InlineSize >= sizeof(void*), "The inline buffer must be able to hold a pointer");
+
+        template<typename Guard>
+        static constexpr bool fits_inline = sizeof(Guard) <= InlineSize &&
+                                            alignof(Guard) <= alignof(std::max_align_t) &&
+                                            std::is_nothrow_move_constructible_v<Guard>;
+
+        const detail::AnyGuardVTable* m_vtable = nullptr;
+        alignas(std::max_align_t) unsigned char m_storage[InlineSize];
+
+        void take(AnyResourceGuard& other) noexcept {
+            if (other.m_vtable) {
+                other.m_vtable->move(m_storage, other.m_storage);
+                m_vtable = std::exchange(other.m_vtable, nullptr);
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructs an empty AnyResourceGuard
+         */
+        AnyResourceGuard() noexcept = default;
+
+        /**
+         * @brief Takes ownership of a guard
+         *
+         * @tparam Guard The guard type (deduced)
+         * @param guard The guard to move in
+         * @throws std::bad_alloc if the guard does not fit inline and allocation fails; the guard is left untouched
+         */
+        template<typename Guard, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Guard>, AnyResourceGuard>>>
+        AnyResourceGuard(Guard&& guard) {
+            using G = std::decay_t<Guard>;
+            static_assert(!std::is_lvalue_reference_v<Guard>, "AnyResourceGuard takes ownership; move the guard in");
+            if constexpr (fits_inline<G>) {
+                ::new (static_cast<void*>(m_storage)) G(std::move(guard));
+                m_vtable = &detail::InlineGuardOps<G>::vtable;
+            } else {
+                ::new (static_cast<void*>(m_storage)) G*(new G(std::move(guard)));
+                m_vtable = &detail::HeapGuardOps<G>::vtable;
+            }
+        }
+
+        /**
+         * @brief Destructor, destroys the held guard which cleans up its resources
+         */
+        ~AnyResourceGuard() { reset(); }
+
+        /**
+         * @brief Move constructor
+         * @param other The AnyResourceGuard to move from; left empty
+         */
+        AnyResourceGuard(AnyResourceGuard&& other) noexcept { take(other); }
+
+        /**
+         * @brief Move assignment, destroys the held guard first
+         * @param other The AnyResourceGuard to move from; left empty
+         * @return Reference to this instance
+         */
+        AnyResourceGuard& operator=(AnyResourceGuard&& other) noexcept {
+            if (this != &other) {
+                reset();
+                take(other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Releases the held guard's resources early, keeping the guard
+         *
+         * Idempotent: a no-op on an empty AnyResourceGuard (default-constructed, moved-from or
+         * reset) and on one whose guard has already been released.
+         */
+        void release() {
+            if (m_vtable) m_vtable->release(m_storage);
+        }
+
+        /**
+         * @brief Destroys the held guard, cleaning up its resources, and becomes empty
+         */
+        void reset() noexcept {
+            if (m_vtable) {
+                m_vtable->destroy(m_storage);
+                m_vtable = nullptr;
+            }
+        }
+
+        /**
+         * @brief Checks whether a guard is held
+         * @return true if not empty
+         */
+        bool has_value() const noexcept { return m_vtable != nullptr; }
+
+        /**
+         * @brief Checks whether the held guard is stored in the inline buffer
+         * @return true if a guard is held inline
+         */
+        bool is_inline() const noexcept { return m_vtable && m_vtable->is_inline; }
+
+        /**
+         * @brief Checks whether a guard is held and owns valid resources
+         * @return true if the held guard converts to true
+         */
+        explicit operator bool() const {
+            return m_vtable && m_vtable->valid(m_storage);
+        }
+
+        /**
+         * @brief Accesses the held guard if it has the given type
+         *
+         * @tparam Guard The expected guard type
+         * @return Pointer to the guard, or nullptr if empty or holding another type
+         */
+        template<typename Guard>
+        Guard* target() noexcept {
+            if constexpr (fits_inline<Guard>) {
+                if (m_vtable != &detail::InlineGuardOps<Guard>::vtable) return nullptr;
+                return &detail::InlineGuardOps<Guard>::get(static_cast<void*>(m_storage));
+            } else {
+                if (m_vtable != &detail::HeapGuardOps<Guard>::vtable) return nullptr;
+                return detail::HeapGuardOps<Guard>::get(static_cast<void*>(m_storage));
+            }
+        }
+
+        /**
+         * @brief Accesses the held guard if it has the given type
+         *
+         * @tparam Guard The expected guard type
+         * @return Pointer to the guard, or nullptr if empty or holding another type
+         */
+        template<typename Guard>
+        const Guard* target() const noexcept {
+            return const_cast<AnyResourceGuard*>(this)->template target<Guard>();
+        }
+
+        /**
+         * @brief Copy constructor (deleted)
+         */
+        AnyResourceGuard(const AnyResourceGuard&) = delete;
+
+        /**
+         * @brief Copy assignment (deleted)
+         */
+        AnyResourceGuard& operator=(const AnyResourceGuard&) = delete;
+    };
+
+} // namespace resourceguard
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "resourceguard.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace resourceguard {
+
+    /**
+     * @brief Deleter for memory carved out of an Arena
+     *
+     * Does nothing: the memory goes back to the arena as a whole when it is reset. Guards using
+     * it are elided on arena reset (see elide_on_arena_reset), so they cost nothing at teardown.
+     */
+    struct ArenaDeleter {
+        static constexpr bool elide_on_arena_reset = true;  ///< Guards with this deleter need no cleanup on reset
+
+        template<typename... Resources>
+        void operator()(Resources&&...) const noexcept {}
+    };
+
+    namespace detail {
+
+        template<typename Deleter, typename = void>
+        struct deleter_elides_on_arena_reset : std::false_type {};
+
+        template<typename Deleter>
+        struct deleter_elides_on_arena_reset<Deleter, std::void_t<decltype(Deleter::elide_on_arena_reset)>>
+            : std::bool_constant<Deleter::elide_on_arena_reset> {};
+
+    } // namespace detail
+
+    /**
+     * @brief Trait marking types whose destruction an Arena may skip on reset
+     *
+     * True for trivially destructible types and for guards and groups whose deleters all
+     * declare `static constexpr bool elide_on_arena_reset = true` (like ArenaDeleter) and whose
+     * resources are trivially destructible. Specialize it for other types whose destructor
+     * only gives memory back to the arena.
+     *
+     * @tparam T The type to check
+     */
+    template<typename T>
+    struct elide_on_arena_reset : std::is_trivially_destructible<T> {};
+
+    template<typename CheckPolicy, typename Deleter, typename... Resources>
+    struct elide_on_arena_reset<BasicResourceGuard<CheckPolicy, Deleter, Resources...>>
+        : std::bool_constant<detail::deleter_elides_on_arena_reset<Deleter>::value &&
+                             (std::is_trivially_destructible_v<Resources> && ...)> {};
+
+    template<typename CheckPolicy, typename... Deleters, typename... Resources>
+    struct elide_on_arena_reset<BasicResourceGroup<CheckPolicy, std::tuple<Deleters...>, Resources...>>
+        : std::bool_constant<(detail::deleter_elides_on_arena_reset<Deleters>::value && ...) &&
+                             (std::is_trivially_destructible_v<Resources> && ...)> {};
+
+    template<typename T>
+    inline constexpr bool elide_on_arena_reset_v = elide_on_arena_reset<T>::value;
+
+    /**
+     * @class Arena
+     * @brief Region allocator whose reset frees everything at once
+     *
+     * Memory is bump-allocated from chunks and returned in one step by reset(), which keeps
+     * the chunks for reuse. Objects created with create() or make_guard() live in the arena:
+     * those marked elide_on_arena_reset (plain memory, guards using ArenaDeleter) are simply
+     * forgotten on reset, while all others (e.g. guards of file descriptors nested in the
+     * request) are put on a cleanup list and destroyed in reverse order of creation. Teardown
+     * therefore costs O(1) plus one call per object that really needs cleanup.
+     *
+     * @code
+     * resourceguard::Arena arena;
+     * auto& buffer = arena.make_guard(resourceguard::ArenaDeleter{}, arena.allocate_array<char>(4096));
+     * auto& file = arena.make_guard<&fclose>(fopen("log.txt", "a"));  // closed on reset
+     * arena.reset();
+     * @endcode
+     *
+     * Not thread-safe; meant to be owned by one request or task.
+     */
+    class Arena {
+        /**
+         * @brief Header of a memory chunk; the usable bytes follow it
+         */
+        struct alignas(std::max_align_t) Chunk {
+            Chunk* next;          ///< Next chunk, reused after this one fills up
+            std::size_t size;     ///< Usable bytes
+
+            unsigned char* begin() noexcept { return reinterpret_cast<unsigned char*>(this + 1); }
+            unsigned char* end() noexcept { return begin() + size; }
+        };
+
+        /**
+         * @brief Record of an object that must be destroyed on reset
+         */
+        struct Cleanup {
+            void (*destroy)(void* object) noexcept;
+            void* object;
+            Cleanup* prev;
+        };
+
+        template<typename T>
+        static void destroy_object(void* object) noexcept {
+            static_cast<T*>(object)->~T();
+        }
+
+        std::size_t m_chunk_size;
+        Chunk* m_first = nullptr;
+        Chunk* m_current = nullptr;
+        unsigned char* m_cursor = nullptr;
+        Cleanup* m_cleanups = nullptr;
+
+        static unsigned char* align_up(unsigned char* p, std::size_t align) noexcept {
+            auto address = reinterpret_cast<std::uintptr_t>(p);
+            return p + ((align - address % align) % align);
+        }
+
+        RESOURCEGUARD_COLD void* allocate_slow(std::size_t size, std::size_t align) {
+            // Reuse the following chunks kept from before the last reset, if one is large enough.
+            for (Chunk* chunk = m_current ? m_current->next : m_first; chunk; chunk = chunk->next) {
+                unsigned char* p = align_up(chunk->begin(), align);
+                m_current = chunk;
+                if (p + size <= chunk->end()) {
+                    m_cursor = p + size;
+                    return p;
+                }
+            }
+            std::size_t usable = size + align > m_chunk_size ? size + align : m_chunk_size;
+            Chunk* chunk = ::new (::operator new(sizeof(Chunk) + usable)) Chunk{ nullptr, usable };
+            if (m_current) m_current->next = chunk;
+            else m_first = chunk;
+            m_current = chunk;
+            unsigned char* p = align_up(chunk->begin(), align);
+            m_cursor = p + size;
+            return p;
+        }
+
+    public:
+        /**
+         * @brief Constructs an empty arena; no memory is allocated until first use
+         * @param chunk_size Usable bytes per chunk; larger requests get a chunk of their own
+         */
+        explicit Arena(std::size_t chunk_size = 64 * 1024) noexcept : m_chunk_size(chunk_size) {}
+
+        /**
+         * @brief Destructor, resets the arena and frees its chunks
+         */
+        ~Arena() {
+            reset();
+            while (m_first) {
+                Chunk* next = m_first->next;
+                ::operator delete(static_cast<void*>(m_first));
+                m_first = next;
+            }
+        }
+
+        /**
+         * @brief Allocates raw memory that lives until the next reset
+         *
+         * @param size Number of bytes
+         * @param align Alignment, a power of two not exceeding alignof(std::max_align_t)
+         * @return Pointer to the memory
+         * @throws std::bad_alloc if a new chunk cannot be allocated
+         */
+        void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t)) {
+            if (m_current) {
+                unsigned char* p = align_up(m_cursor, align);
+                if (p + size <= m_current->end()) {
+                    m_cursor = p + size;
+                    return p;
+                }
+            }
+            return allocate_slow(size, align);
+        }
+
+        /**
+         * @brief Allocates uninitialized storage for an array
+         *
+         * @tparam T The element type
+         * @param count Number of elements
+         * @return Pointer to the first element
+         */
+        template<typename T>
+        T* allocate_array(std::size_t count) {
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+            return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        }
+
+        /**
+         * @brief Constructs an object in the arena
+         *
+         * The object is destroyed on reset unless it is marked elide_on_arena_reset.
+         *
+         * @tparam T The type to construct
+         * @tparam Args Constructor argument types (deduced)
+         * @param args Constructor arguments
+         * @return Reference to the object, valid until the next reset
+         * @throws std::bad_alloc if allocation fails; whatever T's constructor throws
+         */
+        template<typename T, typename... Args>
+        T& create(Args&&... args) {
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+            if constexpr (elide_on_arena_reset_v<T>) {
+                return *::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            } else {
+                // Reserve the record first so nothing can fail once the object exists.
+                auto* cleanup = static_cast<Cleanup*>(allocate(sizeof(Cleanup), alignof(Cleanup)));
+                T* object = ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+                m_cleanups = ::new (cleanup) Cleanup{ &destroy_object<T>, object, m_cleanups };
+                return *object;
+            }
+        }
+
+        /**
+         * @brief Creates a ResourceGuard in the arena
+         *
+         * @tparam Deleter Deleter type (deduced)
+         * @tparam Args Resource types (deduced)
+         * @param deleter The cleanup function; ArenaDeleter for memory from this arena
+         * @param args The resources to manage
+         * @return Reference to the guard, valid until the next reset
+         */
+        template<typename Deleter, typename... Args>
+        auto& make_guard(Deleter&& deleter, Args&&... args) {
+            return create<ResourceGuard<std::decay_t<Deleter>, std::decay_t<Args>...>>(
+                std::forward<Deleter>(deleter), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Creates a ResourceGuard with a compile-time cleanup function in the arena
+         *
+         * @tparam Fn The cleanup function, e.g. `&fclose`
+         * @tparam Args Resource types (deduced)
+         * @param args The resources to manage
+         * @return Reference to the guard, valid until the next reset
+         */
+        template<auto Fn, typename... Args>
+        auto& make_guard(Args&&... args) {
+            return create<FnResourceGuard<Fn, std::decay_t<Args>...>>(FunctionDeleter<Fn>{}, std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Destroys the objects that need cleanup, in reverse order, and recycles all memory
+         *
+         * Objects marked elide_on_arena_reset are not visited. Chunks are kept for reuse.
+         */
+        void reset() noexcept {
+            for (Cleanup* c = m_cleanups; c; c = c->prev) c->destroy(c->object);
+            m_cleanups = nullptr;
+            m_current = m_first;
+            m_cursor = m_first ? m_first->begin() : nullptr;
+        }
+
+        /**
+         * @brief Copy constructor (deleted)
+         */
+        Arena(const Arena&) = delete;
+
+        /**
+         * @brief Copy assignment (deleted)
+         */
+        Arena& operator=(const Arena&) = delete;
+    };
+
+} // namespace resourceguard
@@ -0,0 +1,438 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_scan.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief Index of the lowest set bit of a non-zero word
+         */
+        inline unsigned count_trailing_zeros(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+            unsigned n = 0;
+            while (!(x & 1u)) {
+                x >>= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        /**
+         * @brief Number of set bits in a word
+         */
+        inline unsigned popcount(std::uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+            unsigned n = 0;
+            for (; x; x &= x - 1) ++n;
+            return n;
+#endif
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Calls a function for each run of consecutive values in a set of integral handles
+     * 
+     * Sorts the handles in place (unless already sorted), then calls `fn(first, last)` once per maximal run of
+     * consecutive values (both bounds inclusive). Useful for batch deleters of file
+     * descriptors, e.g. one `close_range(first, last, 0)` per run.
+     * 
+     * @param handles The handles; reordered by this call
+     * @param count The number of handles
+     * @param fn Callable receiving the first and last handle of each run
+     */
+    template<typename T, typename Fn>
+    void for_each_contiguous_run(T* handles, std::size_t count, Fn&& fn) {
+        static_assert(std::is_integral_v<T>, "Runs are only defined for integral handles");
+        if (count == 0) return;
+        if (!std::is_sorted(handles, handles + count)) std::sort(handles, handles + count);
+        T first = handles[0];
+        T last = first;
+        for (std::size_t i = 1; i < count; ++i) {
+            // last + 1 would overflow at the type's maximum (e.g. INT_MAX for int fds).
+            if (handles[i] == last || (last != std::numeric_limits<T>::max() && handles[i] == last + 1)) {
+                last = handles[i];
+                continue;
+            }
+            fn(first, last);
+            first = last = handles[i];
+        }
+        fn(first, last);
+    }
+
+    /**
+     * @class ResourceGuardArray
+     * @brief Contiguous collection of guarded handles sharing one deleter
+     * 
+     * Stores handles in struct-of-arrays form: a dense array of handles plus a packed bitmap of
+     * released elements, and a single deleter for the whole collection. Compared to a vector of
+     * ResourceGuard objects this halves the memory of small handles (no per-element flag or
+     * padding) and allows bulk teardown.
+     * 
+     * Teardown (release_all(), clear() and the destructor) uses the deleter's batch hook when
+     * it provides one:
+     * 
+     * @code
+     * struct FdCloser {
+     *     void operator()(int fd) const noexcept { close(fd); }
+     *     void destroy_batch(int* fds, std::size_t n) const noexcept {
+     *         resourceguard::for_each_contiguous_run(fds, n, [](int lo, int hi) {
+     *             close_range(lo, hi, 0);
+     *         });
+     *     }
+     * };
+     * @endcode
+     * 
+     * The batch hook receives the live handles compacted into one contiguous array. Without a
+     * hook the deleter is called once per live handle.
+     * 
+     * @tparam Deleter A callable type that cleans up one handle
+     * @tparam T The handle type; must be trivially copyable
+     * @tparam CheckPolicy Policy for accessing a released element (ThrowingCheck, AssertingCheck, NoCheck)
+     */
+    template<typename Deleter, typename T, typename CheckPolicy = RESOURCEGUARD_DEFAULT_CHECK_POLICY>
+    class ResourceGuardArray : private detail::DeleterStorage<Deleter> {
+        static_assert(std::is_trivially_copyable_v<T>, "ResourceGuardArray stores trivially copyable handles");
+
+        using DeleterBase = detail::DeleterStorage<Deleter>;
+        using Word = std::uint64_t;
+
+        static constexpr std::size_t word_bits = 64;
+
+        std::vector<T> m_handles;  ///< Handles, live or released
+        std::vector<Word> m_dead;  ///< Bit i is set once handle i has been released or stolen
+
+        bool live(std::size_t i) const noexcept {
+            return !((m_dead[i / word_bits] >> (i % word_bits)) & 1u);
+        }
+
+        void clear_live(std::size_t i) noexcept { m_dead[i / word_bits] |= Word(1) << (i % word_bits); }
+
+        /**
+         * @brief Liveness bits of word w; bits past size() are clear
+         */
+        Word live_bits(std::size_t w) const noexcept {
+            Word bits = ~m_dead[w];
+            std::size_t tail = m_handles.size() - w * word_bits;
+            return tail < word_bits ? bits & ((Word(1) << tail) - 1) : bits;
+        }
+
+        void check_live(std::size_t i, const char* what) const noexcept(CheckPolicy::is_nothrow) {
+            if constexpr (CheckPolicy::enabled) {
+                if (i >= m_handles.size() || !live(i)) CheckPolicy::fail(what);
+            }
+        }
+
+        /**
+         * @brief Cleans up all live handles, in one batch if the deleter supports it
+         */
+        void cleanup() noexcept {
+            if constexpr (detail::has_destroy_batch<Deleter, T>::value) {
+                std::size_t count = 0;
+                for (std::size_t w = 0; w < m_dead.size(); ++w) {
+                    Word bits = live_bits(w);
+                    std::size_t base = w * word_bits;
+                    if (bits == ~Word(0) && count == base) {
+                        count += word_bits;  // fully live word already in place
+                        continue;
+                    }
+                    for (; bits; bits &= bits - 1) {
+                        m_handles[count++] = m_handles[base + detail::count_trailing_zeros(bits)];
+                    }
+                }
+                if (count) detail::invoke_batch_deleter(DeleterBase::deleter(), m_handles.data(), count);
+            } else {
+                for (std::size_t w = 0; w < m_dead.size(); ++w) {
+                    Word bits = live_bits(w);
+                    std::size_t base = w * word_bits;
+                    if (bits == ~Word(0)) {
+                        for (std::size_t i = base; i < base + word_bits; ++i) {
+                            detail::invoke_deleter(DeleterBase::deleter(), m_handles[i]);
+                        }
+                        continue;
+                    }
+                    for (; bits; bits &= bits - 1) {
+                        detail::invoke_deleter(DeleterBase::deleter(),
+                                               m_handles[base + detail::count_trailing_zeros(bits)]);
+                    }
+                }
+            }
+            m_handles.clear();
+            m_dead.clear();
+        }
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+
+        /**
+         * @class reference
+         * @brief Guard-like view of one element
+         */
+        class reference {
+            ResourceGuardArray* m_array;
+            size_type m_index;
+
+        public:
+            reference(ResourceGuardArray& array, size_type index) noexcept : m_array(&array), m_index(index) {}
+
+            /** @brief See ResourceGuardArray::get() */
+            const T& get() const noexcept(CheckPolicy::is_nothrow) { return m_array->get(m_index); }
+
+            /** @brief See ResourceGuardArray::try_get() */
+            std::optional<std::reference_wrapper<const T>> try_get() const { return m_array->try_get(m_index); }
+
+            /** @brief See ResourceGuardArray::release() */
+            void release() noexcept { m_array->release(m_index); }
+
+            /** @brief See ResourceGuardArray::steal() */
+            T steal() { return m_array->steal(m_index); }
+
+            /** @brief See ResourceGuardArray::owns() */
+            bool owns() const noexcept { return m_array->owns(m_index); }
+
+            /**
+             * @brief Checks if the element is owned and passes its ValidityCheck
+             * @return true if the element is owned and valid, false otherwise
+             */
+            explicit operator bool() const {
+                return owns() && ValidityCheck<const T&>::check(m_array->m_handles[m_index]);
+            }
+        };
+
+        /**
+         * @brief Constructs an empty array
+         * 
+         * @param deleter The cleanup function shared by all elements
+         */
+        explicit ResourceGuardArray(Deleter deleter = Deleter{}) : DeleterBase(std::move(deleter)) {}
+
+        /**
+         * @brief Destructor, cleans up all live handles
+         */
+        ~ResourceGuardArray() { cleanup(); }
+
+        /**
+         * @brief Move constructor
+         * 
+         * @param other The ResourceGuardArray to move from
+         */
+        ResourceGuardArray(ResourceGuardArray&& other) noexcept
+            : DeleterBase(static_cast<DeleterBase&&>(other)),
+              m_handles(std::move(other.m_handles)),
+              m_dead(std::move(other.m_dead)) {
+            other.m_handles.clear();
+            other.m_dead.clear();
+        }
+
+        /**
+         * @brief Move assignment operator
+         * 
+         * Cleans up the handles this instance currently owns first
+         * 
+         * @param other The ResourceGuardArray to move from
+         * @return Reference to this instance
+         */
+        ResourceGuardArray& operator=(ResourceGuardArray&& other) noexcept {
+            if (this != &other) {
+                cleanup();
+                DeleterBase::operator=(static_cast<DeleterBase&&>(other));
+                m_handles = std::move(other.m_handles);
+                m_dead = std::move(other.m_dead);
+                other.m_handles.clear();
+                other.m_dead.clear();
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Reserves storage for a number of handles
+         * 
+         * @param count The number of handles to reserve space for
+         */
+        void reserve(size_type count) {
+            m_handles.reserve(count);
+            m_dead.reserve((count + word_bits - 1) / word_bits);
+        }
+
+        /**
+         * @brief Takes ownership of a handle
+         * 
+         * If growing either array throws, the array is left unchanged and does not own the handle.
+         * 
+         * @param handle The handle to manage
+         * @return The index of the new element
+         * @throws std::bad_alloc if the handle or bitmap array cannot grow
+         */
+        size_type push_back(const T& handle) {
+            size_type index = m_handles.size();
+            bool new_word = index % word_bits == 0;
+            if (new_word) m_dead.push_back(0);
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            try {
+                m_handles.push_back(handle);
+            } catch (...) {
+                // Keep the bitmap one word per 64 handles
+                if (new_word) m_dead.pop_back();
+                throw;
+            }
+#else
+            m_handles.push_back(handle);
+#endif
+            return index;
+        }
+
+        /**
+         * @brief Number of elements, including released ones
+         * @return The number of elements
+         */
+        size_type size() const noexcept { return m_handles.size(); }
+
+        /**
+         * @brief Checks whether the array has no elements
+         * @return true if size() is 0
+         */
+        bool empty() const noexcept { return m_handles.empty(); }
+
+        /**
+         * @brief Number of elements still owned
+         * @return The number of live handles
+         */
+        size_type live_count() const noexcept {
+            size_type count = 0;
+            for (std::size_t w = 0; w < m_dead.size(); ++w) count += detail::popcount(live_bits(w));
+            return count;
+        }
+
+        /**
+         * @brief Accesses the handle array, including released elements
+         * @return Pointer to size() contiguous handles
+         */
+        const T* data() const noexcept { return m_handles.data(); }
+
+        /**
+         * @brief Accesses the release bitmap
+         * 
+         * Bit i % 64 of word i / 64 is set once element i has been released or stolen;
+         * bits past size() are unspecified.
+         * 
+         * @return Pointer to (size() + 63) / 64 words
+         */
+        const std::uint64_t* released_words() const noexcept { return m_dead.data(); }
+
+        /**
+         * @brief Computes a bitmap of elements that are owned and valid
+         * 
+         * Scans the handles with scan_valid() (vectorized for sentinel handle types) and masks
+         * out released elements. Useful for reaping dead entries in bulk.
+         * 
+         * @param out Receives (size() + 63) / 64 words; bit i % 64 of word i / 64 is set if element i is owned and valid
+         */
+        void valid_bits(std::uint64_t* out) const {
+            scan_valid(m_handles.data(), m_handles.size(), out);
+            for (std::size_t w = 0; w < m_dead.size(); ++w) out[w] &= live_bits(w);
+        }
+
+        /**
+         * @brief Checks whether an element is still owned
+         * 
+         * @param index The element index
+         * @return true if the element exists and has been neither released nor stolen
+         */
+        bool owns(size_type index) const noexcept { return index < m_handles.size() && live(index); }
+
+        /**
+         * @brief Accesses an element
+         * 
+         * @param index The element index
+         * @return Reference to the handle
+         * @throws std::logic_error if the element does not exist or has been released (ThrowingCheck)
+         */
+        const T& get(size_type index) const noexcept(CheckPolicy::is_nothrow) {
+            check_live(index, "Resource released");
+            return m_handles[index];
+        }
+
+        /**
+         * @brief Safely attempts to access an element
+         * 
+         * @param index The element index
+         * @return An optional containing the handle if owned, nullopt otherwise
+         */
+        std::optional<std::reference_wrapper<const T>> try_get(size_type index) const {
+            if (!owns(index)) return std::nullopt;
+            return std::cref(m_handles[index]);
+        }
+
+        /**
+         * @brief Returns a guard-like view of an element
+         * 
+         * @param index The element index
+         * @return A reference proxy for the element
+         */
+        reference operator[](size_type index) noexcept { return reference(*this, index); }
+
+        /**
+         * @brief Releases a single element
+         * 
+         * Does nothing if the element does not exist or has already been released.
+         * 
+         * @param index The element index
+         */
+        void release(size_type index) noexcept {
+            if (!owns(index)) return;
+            detail::invoke_deleter(DeleterBase::deleter(), m_handles[index]);
+            clear_live(index);
+        }
+
+        /**
+         * @brief Transfers ownership of a single element to caller
+         * 
+         * @param index The element index
+         * @return The handle
+         * @throws std::logic_error if the element does not exist or has been released (ThrowingCheck)
+         */
+        T steal(size_type index) {
+            check_live(index, "Already released");
+            clear_live(index);
+            return m_handles[index];
+        }
+
+        /**
+         * @brief Releases all live elements and removes all elements
+         * 
+         * Uses the deleter's destroy_batch() hook if available.
+         */
+        void release_all() noexcept { cleanup(); }
+
+        /**
+         * @brief Same as release_all()
+         */
+        void clear() noexcept { cleanup(); }
+
+        /**
+         * @brief Copy constructor (deleted)
+         */
+        ResourceGuardArray(const ResourceGuardArray&) = delete;
+
+        /**
+         * @brief Copy assignment operator (deleted)
+         */
+        ResourceGuardArray& operator=(const ResourceGuardArray&) = delete;
+    };
+
+} // namespace resourceguard
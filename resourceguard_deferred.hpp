@@ -0,0 +1,207 @@
+#pragma once
+
+#include "resourceguard.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief Link in the calling thread's list of deferred-deletion queues
+         */
+        struct DeferredQueueLink {
+            DeferredQueueLink* next;                           ///< Next queue of this thread
+            void (*flush)(DeferredQueueLink* self) noexcept;   ///< Cleans up all pending resources
+        };
+
+        inline thread_local DeferredQueueLink* t_deferred_queues = nullptr;
+
+        /**
+         * @brief Per-thread queue of resources waiting for one deleter type
+         *
+         * Flushed when it reaches a threshold, by flush_deferred() and at thread exit. Resources
+         * queued while a flush runs (e.g. by the deleter itself) are picked up by the same flush.
+         * Once the queue is destroyed at thread exit, local() returns nullptr and resources are
+         * cleaned up immediately.
+         *
+         * @tparam Deleter The stateless deleter that cleans up the resources
+         * @tparam T The resource type
+         */
+        template<typename Deleter, typename T>
+        class DeferredQueue : DeferredQueueLink {
+            std::vector<T> m_pending;   ///< Resources waiting for cleanup
+            std::vector<T> m_flushing;  ///< Batch currently handed to the deleter
+            bool m_in_flush = false;
+
+            /**
+             * @brief The calling thread's queue, trivially destructible so it outlives the queue
+             */
+            static inline thread_local DeferredQueue* t_local = nullptr;
+
+            /**
+             * @brief Set once the calling thread's queue has been destroyed at thread exit
+             */
+            static inline thread_local bool t_released = false;
+
+            static void flush_link(DeferredQueueLink* self) noexcept {
+                static_cast<DeferredQueue*>(self)->flush();
+            }
+
+            DeferredQueue() noexcept : DeferredQueueLink{ t_deferred_queues, &flush_link } {
+                t_deferred_queues = this;
+                t_local = this;
+            }
+
+            ~DeferredQueue() {
+                flush();
+                t_local = nullptr;
+                t_released = true;
+                for (DeferredQueueLink** link = &t_deferred_queues; *link; link = &(*link)->next) {
+                    if (*link == this) {
+                        *link = next;
+                        break;
+                    }
+                }
+            }
+
+        public:
+            /**
+             * @brief Returns the calling thread's queue, creating it on first use
+             * @return The queue, or nullptr once it has been destroyed at thread exit
+             */
+            static DeferredQueue* local() noexcept {
+                if (DeferredQueue* queue = t_local) return queue;
+                if (t_released) return nullptr;
+                thread_local DeferredQueue queue;
+                return &queue;
+            }
+
+            /**
+             * @brief Queues a resource, flushing once threshold resources are pending
+             *
+             * Cleans the resource up immediately if it cannot be queued.
+             */
+            void push(T& resource, std::size_t threshold) noexcept {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+                try {
+                    m_pending.push_back(std::move(resource));
+                } catch (...) {
+                    Deleter deleter;
+                    invoke_deleter(deleter, resource);
+                    return;
+                }
+#else
+                m_pending.push_back(std::move(resource));
+#endif
+                if (m_pending.size() >= threshold) flush();
+            }
+
+            /**
+             * @brief Cleans up all pending resources with one batch call where supported
+             */
+            void flush() noexcept {
+                if (m_in_flush) return;
+                m_in_flush = true;
+                while (!m_pending.empty()) {
+                    m_flushing.swap(m_pending);
+                    Deleter deleter;
+                    if constexpr (has_destroy_batch<Deleter, T>::value) {
+                        invoke_batch_deleter(deleter, m_flushing.data(), m_flushing.size());
+                    } else {
+                        for (T& resource : m_flushing) invoke_deleter(deleter, resource);
+                    }
+                    m_flushing.clear();
+                }
+                m_in_flush = false;
+            }
+
+            std::size_t pending() const noexcept { return m_pending.size(); }
+
+            DeferredQueue(const DeferredQueue&) = delete;
+            DeferredQueue& operator=(const DeferredQueue&) = delete;
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Deleter adaptor that defers cleanup to a per-thread batch
+     *
+     * Instead of cleaning up immediately, the resource is appended to the calling thread's queue
+     * for Deleter and T. Once Threshold resources are pending, or when flush_deferred() is
+     * called, or when the thread exits, the whole queue is handed to the deleter at once: to
+     * `destroy_batch(T*, std::size_t)` if it has one (e.g. one `close_range` per run of file
+     * descriptors, see for_each_contiguous_run), otherwise to `operator()` per resource.
+     *
+     * Guards using the same Deleter and resource type share one queue per thread, whatever
+     * their threshold. Deleter must be stateless (default-constructible); resources released on
+     * one thread are cleaned up on that thread. Resources released during thread exit after
+     * the thread's queue is gone (e.g. by other thread-locals' destructors) are cleaned up
+     * immediately.
+     *
+     * @code
+     * using DeferredFd = resourceguard::ResourceGuard<resourceguard::Deferred<CloseFdRange>, int>;
+     * {
+     *     DeferredFd fd(resourceguard::Deferred<CloseFdRange>{}, open(path, O_RDONLY));
+     * }                                  // queued, not closed yet
+     * resourceguard::flush_deferred();   // closed together with the rest of the batch
+     * @endcode
+     *
+     * @tparam Deleter The stateless deleter doing the actual cleanup
+     * @tparam Threshold Number of pending resources that triggers a flush
+     */
+    template<typename Deleter, std::size_t Threshold = 256>
+    struct Deferred {
+        static_assert(std::is_empty_v<Deleter> && std::is_default_constructible_v<Deleter>,
+                      "Deferred cleanup requires a stateless deleter");
+        static_assert(Threshold > 0, "Threshold must be positive");
+
+        template<typename T>
+        void operator()(T& resource) const noexcept {
+            if (auto* queue = detail::DeferredQueue<Deleter, std::remove_const_t<T>>::local()) {
+                queue->push(resource, Threshold);
+            } else {
+                Deleter deleter;
+                detail::invoke_deleter(deleter, resource);
+            }
+        }
+    };
+
+    /**
+     * @brief Cleans up everything the calling thread has deferred
+     *
+     * Call at the end of a batch of work to bound how long resources stay open.
+     */
+    inline void flush_deferred() noexcept {
+        for (detail::DeferredQueueLink* q = detail::t_deferred_queues; q; q = q->next) q->flush(q);
+    }
+
+    /**
+     * @brief Cleans up the calling thread's deferred resources of one deleter and resource type
+     *
+     * @tparam Deleter The deleter wrapped by Deferred
+     * @tparam T The resource type
+     */
+    template<typename Deleter, typename T>
+    void flush_deferred() noexcept {
+        if (auto* queue = detail::DeferredQueue<Deleter, T>::local()) queue->flush();
+    }
+
+    /**
+     * @brief Number of resources of one deleter and resource type the calling thread has deferred
+     *
+     * @tparam Deleter The deleter wrapped by Deferred
+     * @tparam T The resource type
+     * @return The number of pending resources
+     */
+    template<typename Deleter, typename T>
+    std::size_t pending_deferred() noexcept {
+        auto* queue = detail::DeferredQueue<Deleter, T>::local();
+        return queue ? queue->pending() : 0;
+    }
+
+} // namespace resourceguard
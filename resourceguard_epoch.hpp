@@ -0,0 +1,343 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief A guard retired at some global epoch, destroyed two epochs later
+         */
+        struct EpochRetired {
+            std::uint64_t epoch;
+            AnyResourceGuard<> guard;
+
+            template<typename Guard>
+            EpochRetired(std::uint64_t e, Guard&& g) : epoch(e), guard(std::move(g)) {}
+        };
+
+        /**
+         * @brief Per-thread participant in epoch-based reclamation
+         *
+         * `state` is published to other threads: 0 while the thread is outside any pinned
+         * section, `(epoch << 1) | 1` while pinned at that global epoch. The rest is private to
+         * the owning thread. Records are never freed: when a thread exits, its record (including
+         * guards whose grace period has not elapsed yet) is adopted by the next new thread.
+         */
+        struct EpochRecord {
+            std::atomic<std::uint64_t> state{0};  ///< Published pin state
+            std::atomic<bool> owned{true};        ///< Whether a live thread uses this record
+            EpochRecord* next = nullptr;          ///< Next record in the registry
+
+            unsigned pin_depth = 0;               ///< Nesting level of EpochPin on the owner
+            std::size_t since_scan = 0;           ///< Retirements since the last reclamation attempt
+            std::deque<EpochRetired> retired;     ///< Guards awaiting their grace period, oldest first
+        };
+
+        inline std::atomic<std::uint64_t> g_epoch{0};
+        inline std::atomic<EpochRecord*> g_epoch_records{nullptr};
+
+        constexpr std::size_t epoch_scan_threshold = 64;  ///< Retirements between reclamation attempts
+
+        inline EpochRecord* acquire_epoch_record() noexcept {
+            for (EpochRecord* r = g_epoch_records.load(std::memory_order_acquire); r; r = r->next) {
+                bool expected = false;
+                if (!r->owned.load(std::memory_order_relaxed) &&
+                    r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    return r;
+                }
+            }
+            EpochRecord* record = new (std::nothrow) EpochRecord;
+            if (!record) return nullptr;
+            record->next = g_epoch_records.load(std::memory_order_relaxed);
+            while (!g_epoch_records.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                          std::memory_order_relaxed)) {}
+            return record;
+        }
+
+        /**
+         * @brief Advances the global epoch if every pinned thread has observed the current one
+         * @return true if the epoch advanced
+         */
+        inline bool try_advance_epoch() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::uint64_t epoch = g_epoch.load(std::memory_order_relaxed);
+            for (EpochRecord* r = g_epoch_records.load(std::memory_order_acquire); r; r = r->next) {
+                std::uint64_t state = r->state.load(std::memory_order_acquire);
+                if ((state & 1) && (state >> 1) != epoch) return false;
+            }
+            return g_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+        }
+
+        /**
+         * @brief Destroys the retired guards whose grace period has elapsed
+         *
+         * A guard retired at epoch e can no longer be reached once the global epoch is e + 2:
+         * every reader pinned at e or earlier has left its section by then.
+         */
+        inline std::size_t reclaim_expired(EpochRecord& record) noexcept {
+            std::uint64_t epoch = g_epoch.load(std::memory_order_acquire);
+            std::size_t reclaimed = 0;
+            while (!record.retired.empty() && record.retired.front().epoch + 2 <= epoch) {
+                // Unlink the entry before destroying it: its deleter may retire more guards
+                // and re-enter this function.
+                AnyResourceGuard<> guard(std::move(record.retired.front().guard));
+                record.retired.pop_front();
+                guard.reset();
+                ++reclaimed;
+            }
+            return reclaimed;
+        }
+
+        /**
+         * @brief The calling thread's record, or nullptr before first use and after thread exit
+         *
+         * Trivially destructible, so it can still be read while other thread-locals are
+         * destroyed at thread exit, in whatever order that happens.
+         */
+        inline thread_local EpochRecord* t_epoch_record = nullptr;
+
+        /**
+         * @brief Set once the calling thread has given its record up at thread exit
+         */
+        inline thread_local bool t_epoch_record_released = false;
+
+        struct EpochRecordOwner {
+            EpochRecord* record = acquire_epoch_record();
+            EpochRecordOwner() noexcept { t_epoch_record = record; }
+            ~EpochRecordOwner() {
+                if (record) {
+                    try_advance_epoch();
+                    reclaim_expired(*record);
+                }
+                t_epoch_record = nullptr;
+                t_epoch_record_released = true;
+                if (record) record->owned.store(false, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @brief Returns the calling thread's record, or nullptr once it was given up at thread exit
+         */
+        inline EpochRecord* thread_epoch_record() noexcept {
+            if (EpochRecord* record = t_epoch_record) return record;
+            if (t_epoch_record_released) return nullptr;
+            thread_local EpochRecordOwner owner;
+            if (!owner.record) report_misuse("Out of memory registering a thread for epoch-based reclamation");
+            return owner.record;
+        }
+
+        /**
+         * @brief The calling thread's record, or an unowned one borrowed during thread exit
+         *
+         * Deleters run from other thread-locals' destructors may pin and retire after the
+         * thread gave its own record up. They borrow a record from the registry instead, and
+         * give it back when the lease ends.
+         */
+        class EpochRecordLease {
+            EpochRecord* m_record = thread_epoch_record();
+            bool m_borrowed = m_record == nullptr;
+
+        public:
+            EpochRecordLease() noexcept {
+                if (m_borrowed && !(m_record = acquire_epoch_record())) {
+                    report_misuse("Out of memory registering a thread for epoch-based reclamation");
+                }
+            }
+
+            ~EpochRecordLease() {
+                if (m_borrowed) m_record->owned.store(false, std::memory_order_release);
+            }
+
+            bool borrowed() const noexcept { return m_borrowed; }
+            EpochRecord& operator*() const noexcept { return *m_record; }
+            EpochRecord* operator->() const noexcept { return m_record; }
+
+            EpochRecordLease(const EpochRecordLease&) = delete;
+            EpochRecordLease& operator=(const EpochRecordLease&) = delete;
+        };
+
+    } // namespace detail
+
+    /**
+     * @class EpochPin
+     * @brief Marks a read-side critical section for epoch-based reclamation
+     *
+     * While any EpochPin exists on a thread, guards retired with epoch_retire() (or through
+     * EpochRetire) by any thread after the pin was taken are not destroyed, so nodes loaded from
+     * a lock-free structure inside the section stay valid. Pins nest and are cheap: a full
+     * barrier on entry, a store on exit. Keep sections short; a thread stuck in a section holds
+     * back all reclamation.
+     *
+     * @code
+     * {
+     *     resourceguard::EpochPin pin;
+     *     const Route* route = table.lookup(key);   // may be unlinked and retired concurrently
+     *     use(*route);                               // still alive: retirement waits for the pin
+     * }
+     * @endcode
+     */
+    class EpochPin {
+        detail::EpochRecordLease m_record;
+
+    public:
+        /**
+         * @brief Enters a read-side critical section
+         */
+        EpochPin() noexcept {
+            if (m_record->pin_depth++ == 0) {
+                std::uint64_t epoch = detail::g_epoch.load(std::memory_order_relaxed);
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+                // On x86 a locked exchange is a full barrier and cheaper than mfence.
+                m_record->state.exchange((epoch << 1) | 1, std::memory_order_seq_cst);
+#else
+                m_record->state.store((epoch << 1) | 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+            }
+        }
+
+        /**
+         * @brief Leaves the critical section
+         */
+        ~EpochPin() {
+            if (--m_record->pin_depth == 0) m_record->state.store(0, std::memory_order_release);
+        }
+
+        EpochPin(const EpochPin&) = delete;
+        EpochPin& operator=(const EpochPin&) = delete;
+    };
+
+    /**
+     * @brief Destroys a guard once no reader can still reach its resources
+     *
+     * The guard is appended to the calling thread's retire buffer, tagged with the current
+     * global epoch, and destroyed (running its deleter) after the epoch has advanced twice.
+     * Every 64 retirements the thread tries to advance the epoch and destroys the expired
+     * prefix of its buffer, so the scanning cost is amortized. Unlink the resources from the
+     * shared structure before retiring them.
+     *
+     * If the guard cannot be buffered (out of memory), the misuse handler is called and the
+     * program aborts rather than freeing resources that readers may still use.
+     *
+     * Called during thread exit after the thread gave its record up (e.g. by a deleter run
+     * from another thread-local's destructor), it retires through a borrowed record and
+     * waits for the grace period, like epoch_barrier(), so nothing is left behind.
+     *
+     * @tparam Guard The guard type (deduced)
+     * @param guard The guard to retire
+     */
+    template<typename Guard>
+    void epoch_retire(Guard&& guard) noexcept {
+        static_assert(!std::is_lvalue_reference_v<Guard>, "epoch_retire() takes ownership; move the guard in");
+        detail::EpochRecordLease lease;
+        detail::EpochRecord& record = *lease;
+        // Order the caller's unlink before reading the epoch, so the tag is not older than
+        // the epoch of any reader that could still find the resources.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint64_t epoch = detail::g_epoch.load(std::memory_order_relaxed);
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+        try {
+            record.retired.emplace_back(epoch, std::move(guard));
+        } catch (...) {
+            detail::report_misuse("Out of memory retiring a guard; refusing to free it early");
+        }
+#else
+        record.retired.emplace_back(epoch, std::move(guard));
+#endif
+        if (lease.borrowed()) {
+            while (!record.retired.empty()) {
+                detail::try_advance_epoch();
+                detail::reclaim_expired(record);
+                if (!record.retired.empty()) std::this_thread::yield();
+            }
+        } else if (++record.since_scan >= detail::epoch_scan_threshold) {
+            record.since_scan = 0;
+            detail::try_advance_epoch();
+            detail::reclaim_expired(record);
+        }
+    }
+
+    /**
+     * @brief Tries to advance the epoch and destroys the calling thread's expired retirements
+     *
+     * Never blocks. Useful at quiet points when retirements are too rare to trigger the
+     * amortized scan.
+     *
+     * @return The number of guards destroyed
+     */
+    inline std::size_t epoch_reclaim() noexcept {
+        detail::EpochRecord* record = detail::thread_epoch_record();
+        if (!record) return 0;
+        detail::try_advance_epoch();
+        return detail::reclaim_expired(*record);
+    }
+
+    /**
+     * @brief Waits until every guard the calling thread retired has been destroyed
+     *
+     * Spins (yielding) while other threads' pinned sections delay the epoch. Must not be
+     * called inside an EpochPin, which would wait for itself.
+     */
+    inline void epoch_barrier() noexcept {
+        detail::EpochRecord* record = detail::thread_epoch_record();
+        if (!record) return;  // given up at thread exit; later retirements wait for themselves
+        if (record->pin_depth != 0) detail::report_misuse("epoch_barrier() called inside an EpochPin");
+        for (;;) {
+            detail::try_advance_epoch();
+            detail::reclaim_expired(*record);
+            if (record->retired.empty()) return;
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @brief Number of guards the calling thread has retired that are not destroyed yet
+     */
+    inline std::size_t epoch_pending() noexcept {
+        detail::EpochRecord* record = detail::thread_epoch_record();
+        return record ? record->retired.size() : 0;
+    }
+
+    /**
+     * @brief Deleter adaptor that retires resources through epoch-based reclamation
+     *
+     * When the guard is released or destroyed, its resources and a copy of the deleter are
+     * passed to epoch_retire() instead of being cleaned up immediately.
+     *
+     * @code
+     * using RouteGuard = resourceguard::ResourceGuard<resourceguard::EpochRetire<std::default_delete<Route>>, Route*>;
+     * RouteGuard old(resourceguard::EpochRetire<std::default_delete<Route>>(), table.exchange(key, fresh));
+     * // old's destructor retires the route; it is deleted once concurrent readers are done
+     * @endcode
+     *
+     * @tparam Deleter The deleter to run after the grace period
+     */
+    template<typename Deleter>
+    class EpochRetire : private detail::DeleterStorage<Deleter> {
+        using DeleterBase = detail::DeleterStorage<Deleter>;
+
+    public:
+        /**
+         * @brief Constructs the adaptor
+         * @param deleter The wrapped deleter
+         */
+        explicit EpochRetire(Deleter deleter = Deleter()) : DeleterBase(std::move(deleter)) {}
+
+        template<typename... Resources>
+        void operator()(Resources&... resources) const noexcept {
+            epoch_retire(make_resource_guard(this->deleter(), std::move(resources)...));
+        }
+    };
+
+} // namespace resourceguard
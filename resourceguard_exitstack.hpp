@@ -0,0 +1,262 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief Guard that runs a callback once, on release or destruction
+         *
+         * @tparam F The callback type
+         */
+        template<typename F>
+        class CallbackGuard : private DeleterStorage<F> {
+            using DeleterBase = DeleterStorage<F>;
+
+            bool m_armed = true;
+
+        public:
+            template<typename Fn>
+            explicit CallbackGuard(Fn&& fn) : DeleterBase(std::forward<Fn>(fn)) {}
+
+            CallbackGuard(CallbackGuard&& other) noexcept
+                : DeleterBase(static_cast<DeleterBase&&>(other)),
+                  m_armed(std::exchange(other.m_armed, false)) {}
+
+            ~CallbackGuard() {
+                if (m_armed) invoke_deleter(this->deleter());
+            }
+
+            void release() {
+                if (std::exchange(m_armed, false)) this->deleter()();
+            }
+
+            explicit operator bool() const noexcept { return m_armed; }
+
+            CallbackGuard& operator=(CallbackGuard&&) = delete;
+        };
+
+    } // namespace detail
+
+    /**
+     * @class ExitStack
+     * @brief Dynamic LIFO stack of guards, like Python's contextlib.ExitStack
+     *
+     * Takes ownership of any number of guards of arbitrary types (stored as AnyResourceGuard)
+     * and destroys them in reverse order of registration. The first InlineCapacity entries live
+     * inside the stack object; further entries spill into chunks that double in size, so growth
+     * never moves existing entries and references returned by push() stay valid until the
+     * stack is moved.
+     *
+     * @code
+     * resourceguard::ExitStack<> stack;
+     * for (const char* path : paths) {
+     *     stack.emplace<&fclose>(fopen(path, "r"));
+     * }
+     * stack.callback([] { std::puts("all files closed"); });
+     * auto keep = stack.pop_all();  // on success, hand everything to the caller
+     * @endcode
+     *
+     * @tparam InlineCapacity Number of entries stored without allocation
+     * @tparam EntrySize Inline buffer size of each entry; larger guards are heap-allocated
+     */
+    template<std::size_t InlineCapacity = 8, std::size_t EntrySize = 32>
+    class ExitStack {
+        static_assert(InlineCapacity > 0, "ExitStack needs at least one inline entry");
+
+    public:
+        using Entry = AnyResourceGuard<EntrySize>;
+
+    private:
+        /**
+         * @brief Header of a spill chunk; the entries follow it in the same allocation
+         */
+        struct alignas(Entry) Chunk {
+            Chunk* prev;           ///< Previously allocated chunk, unwound after this one
+            std::size_t count;     ///< Number of constructed entries
+            std::size_t capacity;  ///< Number of entries that fit
+
+            Entry* entries() noexcept { return reinterpret_cast<Entry*>(this + 1); }
+        };
+
+        detail::ManualSlot<Entry> m_inline[InlineCapacity];
+        std::size_t m_inline_count = 0;
+        Chunk* m_top = nullptr;
+        std::size_t m_size = 0;
+
+        static void destroy_chunk(Chunk* chunk) noexcept {
+            Entry* entries = chunk->entries();
+            for (std::size_t i = chunk->count; i-- > 0;) entries[i].~Entry();
+            ::operator delete(static_cast<void*>(chunk));
+        }
+
+        /**
+         * @brief Returns uninitialized memory for the next entry, allocating a chunk if needed
+         */
+        void* next_slot() {
+            if (m_inline_count < InlineCapacity) return std::addressof(m_inline[m_inline_count].value);
+            if (!m_top || m_top->count == m_top->capacity) {
+                std::size_t capacity = m_top ? m_top->capacity * 2 : InlineCapacity * 2;
+                void* memory = ::operator new(sizeof(Chunk) + capacity * sizeof(Entry));
+                m_top = ::new (memory) Chunk{ m_top, 0, capacity };
+            }
+            return m_top->entries() + m_top->count;
+        }
+
+        void commit_slot() noexcept {
+            if (m_inline_count < InlineCapacity) ++m_inline_count;
+            else ++m_top->count;
+            ++m_size;
+        }
+
+        void take(ExitStack& other) noexcept {
+            for (std::size_t i = 0; i < other.m_inline_count; ++i) {
+                m_inline[i].construct(std::move(other.m_inline[i].value));
+                other.m_inline[i].destroy();
+            }
+            m_inline_count = std::exchange(other.m_inline_count, 0);
+            m_top = std::exchange(other.m_top, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+
+    public:
+        /**
+         * @brief Constructs an empty stack
+         */
+        ExitStack() noexcept {}
+
+        /**
+         * @brief Destructor, destroys all entries in reverse order of registration
+         */
+        ~ExitStack() { close(); }
+
+        /**
+         * @brief Move constructor, takes over all entries of another stack
+         * @param other The stack to move from; left empty
+         */
+        ExitStack(ExitStack&& other) noexcept { take(other); }
+
+        /**
+         * @brief Move assignment, closes this stack then takes over all entries of another
+         * @param other The stack to move from; left empty
+         * @return Reference to this instance
+         */
+        ExitStack& operator=(ExitStack&& other) noexcept {
+            if (this != &other) {
+                close();
+                take(other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Takes ownership of a guard
+         *
+         * @tparam Guard The guard type (deduced)
+         * @param guard The guard to move in
+         * @return Reference to the stored guard, valid until it is destroyed or the stack is moved
+         * @throws std::bad_alloc if allocation fails; the guard is left untouched
+         */
+        template<typename Guard>
+        std::decay_t<Guard>& push(Guard&& guard) {
+            static_assert(!std::is_lvalue_reference_v<Guard>, "ExitStack takes ownership; move the guard in");
+            Entry* entry = ::new (next_slot()) Entry(std::move(guard));
+            commit_slot();
+            return *entry->template target<std::decay_t<Guard>>();
+        }
+
+        /**
+         * @brief Creates a guard from a deleter and resources and pushes it
+         *
+         * @tparam Deleter Deleter type (deduced)
+         * @tparam Args Resource types (deduced)
+         * @param deleter The cleanup function
+         * @param args The resources to manage
+         * @return Reference to the stored guard
+         */
+        template<typename Deleter, typename... Args>
+        auto& emplace(Deleter&& deleter, Args&&... args) {
+            return push(make_resource_guard(std::forward<Deleter>(deleter), std::forward<Args>(args)...));
+        }
+
+        /**
+         * @brief Creates a guard with a compile-time cleanup function and pushes it
+         *
+         * @tparam Fn The cleanup function, e.g. `&fclose`
+         * @tparam Args Resource types (deduced)
+         * @param args The resources to manage
+         * @return Reference to the stored guard
+         */
+        template<auto Fn, typename... Args>
+        auto& emplace(Args&&... args) {
+            return push(make_resource_guard<Fn>(std::forward<Args>(args)...));
+        }
+
+        /**
+         * @brief Registers a callback to run when the stack unwinds
+         *
+         * @tparam F Callback type (deduced)
+         * @param fn Callable taking no arguments
+         */
+        template<typename F>
+        void callback(F&& fn) {
+            push(detail::CallbackGuard<std::decay_t<F>>(std::forward<F>(fn)));
+        }
+
+        /**
+         * @brief Moves all entries into a new stack in O(InlineCapacity)
+         *
+         * Spill chunks are handed over by pointer, so the cost does not grow with the number
+         * of entries; the up to InlineCapacity inline entries are moved one by one.
+         * Typically used once acquisition succeeded, to keep the resources alive beyond the
+         * scope of this stack.
+         *
+         * @return A stack owning all entries; this stack is left empty
+         */
+        ExitStack pop_all() noexcept {
+            return std::move(*this);
+        }
+
+        /**
+         * @brief Destroys all entries now, in reverse order of registration
+         */
+        void close() noexcept {
+            while (m_top) {
+                Chunk* prev = m_top->prev;
+                destroy_chunk(m_top);
+                m_top = prev;
+            }
+            while (m_inline_count > 0) m_inline[--m_inline_count].destroy();
+            m_size = 0;
+        }
+
+        /**
+         * @brief Number of entries on the stack
+         */
+        std::size_t size() const noexcept { return m_size; }
+
+        /**
+         * @brief Checks whether the stack holds no entries
+         */
+        bool empty() const noexcept { return m_size == 0; }
+
+        /**
+         * @brief Copy constructor (deleted)
+         */
+        ExitStack(const ExitStack&) = delete;
+
+        /**
+         * @brief Copy assignment (deleted)
+         */
+        ExitStack& operator=(const ExitStack&) = delete;
+    };
+
+} // namespace resourceguard
@@ -0,0 +1,364 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief A guard retired while its resource may still be protected
+         */
+        struct HazardRetired {
+            const void* pointer;      ///< The address readers protect
+            AnyResourceGuard<> guard; ///< Destroyed once no hazard pointer holds `pointer`
+
+            template<typename Guard>
+            HazardRetired(const void* p, Guard&& g) : pointer(p), guard(std::move(g)) {}
+        };
+
+        /**
+         * @brief Per-thread hazard pointer slots and retire list
+         *
+         * The slots are published to scanning threads; everything else is private to the owning
+         * thread. Records are never freed: when a thread exits, its record (including retired
+         * guards that were still protected) is adopted by the next new thread.
+         */
+        struct HazardRecord {
+            static constexpr unsigned slot_count = 8;  ///< Hazard pointers per thread
+
+            std::atomic<const void*> slots[slot_count] = {};  ///< Published protected addresses
+            std::atomic<bool> owned{true};                    ///< Whether a live thread uses this record
+            HazardRecord* next = nullptr;                     ///< Next record in the registry
+
+            unsigned used = 0;                    ///< Bitmask of slots held by a HazardPointer
+            bool scanning = false;                ///< Set while destroying guards, to defer nested scans
+            std::vector<HazardRetired> retired;   ///< Guards awaiting a scan
+            std::vector<HazardRetired> expired;   ///< Guards being destroyed by the current scan
+            std::vector<const void*> hazards;     ///< Published hazards collected by the current scan
+        };
+
+        inline std::atomic<HazardRecord*> g_hazard_records{nullptr};
+        inline std::atomic<std::size_t> g_hazard_record_count{0};
+
+        inline HazardRecord* acquire_hazard_record() noexcept {
+            for (HazardRecord* r = g_hazard_records.load(std::memory_order_acquire); r; r = r->next) {
+                bool expected = false;
+                if (!r->owned.load(std::memory_order_relaxed) &&
+                    r->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    return r;
+                }
+            }
+            HazardRecord* record = new (std::nothrow) HazardRecord;
+            if (!record) return nullptr;
+            record->next = g_hazard_records.load(std::memory_order_relaxed);
+            while (!g_hazard_records.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                           std::memory_order_relaxed)) {}
+            g_hazard_record_count.fetch_add(1, std::memory_order_relaxed);
+            return record;
+        }
+
+        /**
+         * @brief Number of retired guards that triggers a scan
+         *
+         * Proportional to the number of hazard pointers, so each scan reclaims at least half of
+         * the list and the cost per retirement stays constant.
+         */
+        inline std::size_t hazard_scan_threshold() noexcept {
+            std::size_t hazards = g_hazard_record_count.load(std::memory_order_relaxed) * HazardRecord::slot_count;
+            return hazards * 2 > 64 ? hazards * 2 : 64;
+        }
+
+        /**
+         * @brief Destroys the retired guards whose resources no hazard pointer protects
+         * @return The number of guards destroyed
+         */
+        inline std::size_t hazard_scan(HazardRecord& record) noexcept {
+            if (record.scanning || record.retired.empty()) return 0;
+            std::size_t max_hazards = g_hazard_record_count.load(std::memory_order_acquire) * HazardRecord::slot_count;
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            try {
+                record.hazards.reserve(max_hazards);
+                record.expired.reserve(record.retired.size());
+            } catch (...) {
+                return 0;  // keep everything; retry on the next scan
+            }
+#else
+            record.hazards.reserve(max_hazards);
+            record.expired.reserve(record.retired.size());
+#endif
+            record.scanning = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            for (HazardRecord* r = g_hazard_records.load(std::memory_order_acquire); r; r = r->next) {
+                for (auto& slot : r->slots) {
+                    const void* p = slot.load(std::memory_order_acquire);
+                    if (!p) continue;
+                    if (record.hazards.size() == record.hazards.capacity()) {
+                        // A thread registered since max_hazards was read; keep everything this time.
+                        record.hazards.clear();
+                        record.scanning = false;
+                        return 0;
+                    }
+                    record.hazards.push_back(p);
+                }
+            }
+            std::sort(record.hazards.begin(), record.hazards.end());
+
+            // Move unprotected guards out first, so deleters that retire more guards
+            // append to a consistent list.
+            std::size_t kept = 0;
+            for (HazardRetired& entry : record.retired) {
+                if (std::binary_search(record.hazards.begin(), record.hazards.end(), entry.pointer)) {
+                    if (&record.retired[kept] != &entry) record.retired[kept] = std::move(entry);
+                    ++kept;
+                } else {
+                    record.expired.push_back(std::move(entry));
+                }
+            }
+            record.retired.erase(record.retired.begin() + static_cast<std::ptrdiff_t>(kept), record.retired.end());
+            std::size_t reclaimed = record.expired.size();
+            record.hazards.clear();
+            record.expired.clear();
+            record.scanning = false;
+            return reclaimed;
+        }
+
+        /**
+         * @brief The calling thread's record, or nullptr before first use and after thread exit
+         *
+         * Trivially destructible, so it can still be read while other thread-locals are
+         * destroyed at thread exit, in whatever order that happens.
+         */
+        inline thread_local HazardRecord* t_hazard_record = nullptr;
+
+        /**
+         * @brief Set once the calling thread has given its record up at thread exit
+         */
+        inline thread_local bool t_hazard_record_released = false;
+
+        struct HazardRecordOwner {
+            HazardRecord* record = acquire_hazard_record();
+            HazardRecordOwner() noexcept { t_hazard_record = record; }
+            ~HazardRecordOwner() {
+                if (record) hazard_scan(*record);
+                t_hazard_record = nullptr;
+                t_hazard_record_released = true;
+                if (record) record->owned.store(false, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @brief Returns the calling thread's record, or nullptr once it was given up at thread exit
+         */
+        inline HazardRecord* thread_hazard_record() noexcept {
+            if (HazardRecord* record = t_hazard_record) return record;
+            if (t_hazard_record_released) return nullptr;
+            thread_local HazardRecordOwner owner;
+            if (!owner.record) report_misuse("Out of memory registering a thread for hazard pointers");
+            return owner.record;
+        }
+
+        /**
+         * @brief The calling thread's record, or an unowned one borrowed during thread exit
+         *
+         * Deleters run from other thread-locals' destructors may protect and retire after the
+         * thread gave its own record up. They borrow a record from the registry instead, and
+         * give it back when the lease ends.
+         */
+        class HazardRecordLease {
+            HazardRecord* m_record = thread_hazard_record();
+            bool m_borrowed = m_record == nullptr;
+
+        public:
+            HazardRecordLease() noexcept {
+                if (m_borrowed && !(m_record = acquire_hazard_record())) {
+                    report_misuse("Out of memory registering a thread for hazard pointers");
+                }
+            }
+
+            ~HazardRecordLease() {
+                if (m_borrowed) m_record->owned.store(false, std::memory_order_release);
+            }
+
+            bool borrowed() const noexcept { return m_borrowed; }
+            HazardRecord& operator*() const noexcept { return *m_record; }
+            HazardRecord* operator->() const noexcept { return m_record; }
+
+            HazardRecordLease(const HazardRecordLease&) = delete;
+            HazardRecordLease& operator=(const HazardRecordLease&) = delete;
+        };
+
+    } // namespace detail
+
+    /**
+     * @class HazardPointer
+     * @brief Protects one pointer loaded from shared memory against reclamation
+     *
+     * While a HazardPointer protects an address, guards retired with hazard_retire() (or
+     * through HazardRetire) for that address are not destroyed. Unlike an EpochPin, a stalled
+     * reader only holds back the resources it actually protects, so unreclaimed memory stays
+     * bounded. Each thread can hold up to 8 hazard pointers at a time.
+     *
+     * @code
+     * resourceguard::HazardPointer hp;
+     * Route* route = hp.protect(table.slot(key));  // safe to use until hp is reset or destroyed
+     * use(*route);
+     * @endcode
+     */
+    class HazardPointer {
+        detail::HazardRecordLease m_record;
+        unsigned m_index = 0;
+
+    public:
+        /**
+         * @brief Acquires an empty hazard pointer slot on the calling thread
+         */
+        HazardPointer() noexcept {
+            unsigned free_slots = ~m_record->used & ((1u << detail::HazardRecord::slot_count) - 1);
+            if (!free_slots) detail::report_misuse("Too many hazard pointers on one thread");
+            while (!(free_slots & (1u << m_index))) ++m_index;
+            m_record->used |= 1u << m_index;
+        }
+
+        /**
+         * @brief Clears the protection and returns the slot
+         */
+        ~HazardPointer() {
+            reset();
+            m_record->used &= ~(1u << m_index);
+        }
+
+        /**
+         * @brief Loads a pointer and protects it
+         *
+         * Publishes the loaded value and re-reads the source until both agree, so the returned
+         * pointer was still reachable when the protection became visible to reclaimers.
+         *
+         * @tparam T The pointed-to type
+         * @param source The shared pointer to load
+         * @return The protected pointer (may be nullptr)
+         */
+        template<typename T>
+        T* protect(const std::atomic<T*>& source) noexcept {
+            T* p = source.load(std::memory_order_relaxed);
+            for (;;) {
+                m_record->slots[m_index].store(p, std::memory_order_seq_cst);
+                T* again = source.load(std::memory_order_seq_cst);
+                if (again == p) return p;
+                p = again;
+            }
+        }
+
+        /**
+         * @brief Protects an address known to be reachable, without validation
+         * @param p The address to protect, or nullptr to clear
+         */
+        void reset(const void* p = nullptr) noexcept {
+            m_record->slots[m_index].store(p, p ? std::memory_order_seq_cst : std::memory_order_release);
+        }
+
+        HazardPointer(const HazardPointer&) = delete;
+        HazardPointer& operator=(const HazardPointer&) = delete;
+    };
+
+    /**
+     * @brief Destroys a guard once no hazard pointer protects the given address
+     *
+     * The guard is appended to the calling thread's retire list. When the list exceeds twice
+     * the number of hazard pointers (at least 64), the thread collects all published hazard
+     * pointers and destroys every guard whose address is not among them. Unlink the resource
+     * from the shared structure before retiring it.
+     *
+     * If the guard cannot be buffered (out of memory), the misuse handler is called and the
+     * program aborts rather than freeing a resource that readers may still use.
+     *
+     * Called during thread exit after the thread gave its record up (e.g. by a deleter run
+     * from another thread-local's destructor), it retires through a borrowed record and scans
+     * until the guard is destroyed, so nothing is left behind.
+     *
+     * @tparam Guard The guard type (deduced)
+     * @param pointer The address readers protect, usually the managed pointer
+     * @param guard The guard to retire
+     */
+    template<typename Guard>
+    void hazard_retire(const void* pointer, Guard&& guard) noexcept {
+        static_assert(!std::is_lvalue_reference_v<Guard>, "hazard_retire() takes ownership; move the guard in");
+        detail::HazardRecordLease lease;
+        detail::HazardRecord& record = *lease;
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+        try {
+            record.retired.emplace_back(pointer, std::move(guard));
+        } catch (...) {
+            detail::report_misuse("Out of memory retiring a guard; refusing to free it early");
+        }
+#else
+        record.retired.emplace_back(pointer, std::move(guard));
+#endif
+        if (lease.borrowed()) {
+            while (!record.retired.empty()) {
+                detail::hazard_scan(record);
+                if (!record.retired.empty()) std::this_thread::yield();
+            }
+        } else if (record.retired.size() >= detail::hazard_scan_threshold()) {
+            detail::hazard_scan(record);
+        }
+    }
+
+    /**
+     * @brief Destroys the calling thread's retired guards that are no longer protected
+     * @return The number of guards destroyed
+     */
+    inline std::size_t hazard_reclaim() noexcept {
+        detail::HazardRecord* record = detail::thread_hazard_record();
+        return record ? detail::hazard_scan(*record) : 0;
+    }
+
+    /**
+     * @brief Number of guards the calling thread has retired that are not destroyed yet
+     */
+    inline std::size_t hazard_pending() noexcept {
+        detail::HazardRecord* record = detail::thread_hazard_record();
+        return record ? record->retired.size() : 0;
+    }
+
+    /**
+     * @brief Deleter adaptor that retires a pointer resource through hazard pointers
+     *
+     * When the guard is released or destroyed, the pointer and a copy of the deleter are passed
+     * to hazard_retire(), keyed by the pointer itself.
+     *
+     * @code
+     * using RouteGuard = resourceguard::ResourceGuard<resourceguard::HazardRetire<std::default_delete<Route>>, Route*>;
+     * RouteGuard old(resourceguard::HazardRetire<std::default_delete<Route>>(), table.exchange(key, fresh));
+     * @endcode
+     *
+     * @tparam Deleter The deleter to run once the pointer is unprotected
+     */
+    template<typename Deleter>
+    class HazardRetire : private detail::DeleterStorage<Deleter> {
+        using DeleterBase = detail::DeleterStorage<Deleter>;
+
+    public:
+        /**
+         * @brief Constructs the adaptor
+         * @param deleter The wrapped deleter
+         */
+        explicit HazardRetire(Deleter deleter = Deleter()) : DeleterBase(std::move(deleter)) {}
+
+        template<typename T>
+        void operator()(T* pointer) const noexcept {
+            hazard_retire(pointer, make_resource_guard(this->deleter(), pointer));
+        }
+    };
+
+} // namespace resourceguard
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace resourceguard {
+
+    /**
+     * @brief What AsyncReclaimer::retire() does when the queue is full
+     */
+    enum class Backpressure {
+        Block,     ///< Wait until a worker makes room
+        RunInline  ///< Clean the resource up on the calling thread
+    };
+
+    /**
+     * @brief Configuration of an AsyncReclaimer
+     */
+    struct ReclaimerOptions {
+        std::size_t capacity = 4096;                     ///< Maximum number of queued guards
+        std::size_t workers = 1;                         ///< Number of background threads
+        Backpressure backpressure = Backpressure::Block; ///< Behaviour when the queue is full
+    };
+
+    class AsyncReclaimer;
+
+    namespace detail {
+
+        /**
+         * @brief The reclaimer whose worker is the calling thread, or nullptr
+         */
+        inline thread_local const AsyncReclaimer* t_reclaimer_worker = nullptr;
+
+    } // namespace detail
+
+    /**
+     * @class AsyncReclaimer
+     * @brief Destroys guards on background threads
+     *
+     * Guards handed to retire() are moved into a bounded queue and destroyed, which runs their
+     * deleters, by a pool of worker threads. Meant for deleters that may block (close() on
+     * network file systems, munmap of large regions, fclose flushing buffers) so that request
+     * threads only pay for a queue push. See also Async, which turns any deleter into one that
+     * retires through a reclaimer.
+     *
+     * On shutdown (or destruction) the reclaimer stops accepting work, and the workers drain
+     * the queue before exiting; guards retired afterwards are cleaned up inline.
+     *
+     * Deleters running on a worker may retire into the same reclaimer: when the queue is full
+     * the guard is cleaned up inline rather than waiting for room only the workers can make.
+     * They may also call shutdown(), which then joins the other workers and leaves the calling
+     * one to a later shutdown() or the destructor. Calling drain() or destroying the reclaimer
+     * from its own worker would wait for itself and is reported as misuse.
+     */
+    class AsyncReclaimer {
+    public:
+        using Entry = AnyResourceGuard<>;
+
+    private:
+        static constexpr std::size_t batch_size = 32;  ///< Guards a worker takes per lock acquisition
+
+        std::vector<Entry> m_ring;
+        std::size_t m_head = 0;
+        std::size_t m_count = 0;
+        std::size_t m_in_flight = 0;
+        bool m_stopping = false;
+        Backpressure m_backpressure;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_not_empty;
+        std::condition_variable m_not_full;
+        std::condition_variable m_idle;
+        std::vector<std::thread> m_workers;
+
+        bool on_worker() const noexcept { return detail::t_reclaimer_worker == this; }
+
+        void work() {
+            detail::t_reclaimer_worker = this;
+            Entry batch[batch_size];
+            std::unique_lock<std::mutex> lock(m_mutex);
+            for (;;) {
+                m_not_empty.wait(lock, [this] { return m_count > 0 || m_stopping; });
+                if (m_count == 0) return;
+                std::size_t taken = m_count < batch_size ? m_count : batch_size;
+                for (std::size_t i = 0; i < taken; ++i) {
+                    batch[i] = std::move(m_ring[m_head]);
+                    m_head = (m_head + 1) % m_ring.size();
+                }
+                m_count -= taken;
+                m_in_flight += taken;
+                lock.unlock();
+                m_not_full.notify_all();
+                for (std::size_t i = 0; i < taken; ++i) batch[i].reset();
+                lock.lock();
+                m_in_flight -= taken;
+                if (m_count == 0 && m_in_flight == 0) m_idle.notify_all();
+            }
+        }
+
+        bool enqueue(Entry& entry) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_count == m_ring.size() && !m_stopping) {
+                // A worker waiting for room would wait for itself.
+                if (m_backpressure == Backpressure::RunInline || on_worker()) return false;
+                m_not_full.wait(lock, [this] { return m_count < m_ring.size() || m_stopping; });
+            }
+            if (m_stopping) return false;
+            m_ring[(m_head + m_count) % m_ring.size()] = std::move(entry);
+            ++m_count;
+            lock.unlock();
+            m_not_empty.notify_one();
+            return true;
+        }
+
+    public:
+        /**
+         * @brief Starts the worker threads
+         *
+         * @param options Queue capacity, worker count and backpressure policy
+         * @throws std::system_error if a thread cannot be started
+         */
+        explicit AsyncReclaimer(ReclaimerOptions options = {})
+            : m_ring(options.capacity ? options.capacity : 1), m_backpressure(options.backpressure) {
+            std::size_t workers = options.workers ? options.workers : 1;
+            m_workers.reserve(workers);
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            try {
+                for (std::size_t i = 0; i < workers; ++i) m_workers.emplace_back([this] { work(); });
+            } catch (...) {
+                shutdown();
+                throw;
+            }
+#else
+            for (std::size_t i = 0; i < workers; ++i) m_workers.emplace_back([this] { work(); });
+#endif
+        }
+
+        /**
+         * @brief Destructor, drains the queue and joins the workers
+         */
+        ~AsyncReclaimer() {
+            if (on_worker()) {
+                detail::report_misuse("AsyncReclaimer destroyed by one of its own workers");
+            }
+            shutdown();
+        }
+
+        /**
+         * @brief Hands a guard to the background workers
+         *
+         * If the guard cannot be queued (queue full under Backpressure::RunInline or on one of
+         * this reclaimer's workers, or the reclaimer is shut down), it is destroyed on the
+         * calling thread instead.
+         *
+         * @tparam Guard The guard type (deduced)
+         * @param guard The guard to retire
+         * @return true if queued, false if cleaned up inline
+         */
+        template<typename Guard>
+        bool retire(Guard&& guard) {
+            static_assert(!std::is_lvalue_reference_v<Guard>, "retire() takes ownership; move the guard in");
+            Entry entry(std::move(guard));
+            return enqueue(entry);
+        }
+
+        /**
+         * @brief Waits until every queued guard has been destroyed
+         *
+         * Must not be called from this reclaimer's workers, which would wait for themselves.
+         */
+        void drain() {
+            if (on_worker()) {
+                detail::report_misuse("AsyncReclaimer::drain() called from one of its own workers");
+            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this] { return m_count == 0 && m_in_flight == 0; });
+        }
+
+        /**
+         * @brief Stops accepting work, lets the workers drain the queue and joins them
+         *
+         * Idempotent. Called from one of the workers (by a deleter), it joins the others and
+         * leaves the calling worker, which exits once it finishes its batch, to be joined by a
+         * later shutdown() or the destructor.
+         */
+        void shutdown() noexcept {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_not_empty.notify_all();
+            m_not_full.notify_all();
+            const std::thread::id self = std::this_thread::get_id();
+            for (std::thread& worker : m_workers) {
+                if (worker.joinable() && worker.get_id() != self) worker.join();
+            }
+        }
+
+        /**
+         * @brief Number of guards queued or being destroyed
+         */
+        std::size_t backlog() const {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_count + m_in_flight;
+        }
+
+        AsyncReclaimer(const AsyncReclaimer&) = delete;
+        AsyncReclaimer& operator=(const AsyncReclaimer&) = delete;
+    };
+
+    /**
+     * @brief Deleter adaptor that runs the wrapped deleter on an AsyncReclaimer
+     *
+     * On cleanup, the resources and a copy of the deleter are moved into a new guard which is
+     * retired to the reclaimer, so the guard's destructor only costs a queue push. If that
+     * fails (e.g. out of memory), the wrapped deleter runs inline.
+     *
+     * @code
+     * resourceguard::AsyncReclaimer reclaimer({ 1024, 2 });
+     * resourceguard::ResourceGuard<resourceguard::Async<FileCloser>, FILE*> file(
+     *     resourceguard::Async<FileCloser>(reclaimer), fopen("/nfs/log.txt", "a"));
+     * @endcode
+     *
+     * @tparam Deleter The (possibly slow) deleter to run in the background
+     */
+    template<typename Deleter>
+    class Async : private detail::DeleterStorage<Deleter> {
+        using DeleterBase = detail::DeleterStorage<Deleter>;
+
+        AsyncReclaimer* m_reclaimer;
+
+    public:
+        /**
+         * @brief Constructs the adaptor
+         * @param reclaimer The reclaimer to retire to; must outlive all guards using this deleter
+         * @param deleter The wrapped deleter
+         */
+        explicit Async(AsyncReclaimer& reclaimer, Deleter deleter = Deleter())
+            : DeleterBase(std::move(deleter)), m_reclaimer(&reclaimer) {}
+
+        template<typename... Resources>
+        void operator()(Resources&... resources) const noexcept {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            try {
+                m_reclaimer->retire(make_resource_guard(this->deleter(), std::move(resources)...));
+            } catch (...) {
+                // The temporary guard has already cleaned up inline.
+            }
+#else
+            m_reclaimer->retire(make_resource_guard(this->deleter(), std::move(resources)...));
+#endif
+        }
+    };
+
+    /**
+     * @class IncrementalReclaimer
+     * @brief Destroys retired guards a slice at a time, for event loops
+     *
+     * Guards handed to retire() are queued in FIFO order and destroyed only when run() or
+     * run_for() is called, at most up to the given count or time budget. Calling it once per
+     * event-loop tick spreads the teardown of a large structure (e.g. thousands of connections
+     * after a mass disconnect) over many ticks instead of one long stall.
+     *
+     * Not thread-safe; owned by the event loop. Remaining guards are destroyed with the
+     * reclaimer.
+     */
+    class IncrementalReclaimer {
+    public:
+        using Entry = AnyResourceGuard<>;
+        using Clock = std::chrono::steady_clock;
+
+    private:
+        std::deque<Entry> m_backlog;
+
+        void destroy_front() noexcept {
+            m_backlog.front().reset();
+            m_backlog.pop_front();
+        }
+
+    public:
+        IncrementalReclaimer() = default;
+
+        /**
+         * @brief Queues a guard for incremental destruction
+         *
+         * @tparam Guard The guard type (deduced)
+         * @param guard The guard to retire
+         * @throws std::bad_alloc if the guard cannot be queued; the guard is left untouched
+         */
+        template<typename Guard>
+        void retire(Guard&& guard) {
+            static_assert(!std::is_lvalue_reference_v<Guard>, "retire() takes ownership; move the guard in");
+            m_backlog.emplace_back(std::move(guard));
+        }
+
+        /**
+         * @brief Destroys up to max_count retired guards
+         *
+         * @param max_count Maximum number of guards to destroy in this slice
+         * @return The number of guards destroyed
+         */
+        std::size_t run(std::size_t max_count) noexcept {
+            std::size_t done = 0;
+            while (done < max_count && !m_backlog.empty()) {
+                destroy_front();
+                ++done;
+            }
+            return done;
+        }
+
+        /**
+         * @brief Destroys retired guards until the time budget is used up
+         *
+         * Always destroys at least one guard if any are pending, so the backlog keeps
+         * shrinking even when single deleters exceed the budget.
+         *
+         * @param budget Time allowed for this slice
+         * @param max_count Maximum number of guards to destroy in this slice
+         * @return The number of guards destroyed
+         */
+        std::size_t run_for(Clock::duration budget, std::size_t max_count = SIZE_MAX) noexcept {
+            const Clock::time_point deadline = Clock::now() + budget;
+            std::size_t done = 0;
+            while (done < max_count && !m_backlog.empty()) {
+                destroy_front();
+                ++done;
+                if (Clock::now() >= deadline) break;
+            }
+            return done;
+        }
+
+        /**
+         * @brief Destroys all retired guards now
+         */
+        void drain() noexcept {
+            while (!m_backlog.empty()) destroy_front();
+        }
+
+        /**
+         * @brief Number of guards waiting to be destroyed
+         */
+        std::size_t backlog() const noexcept { return m_backlog.size(); }
+
+        /**
+         * @brief Checks whether nothing is waiting to be destroyed
+         */
+        bool empty() const noexcept { return m_backlog.empty(); }
+
+        IncrementalReclaimer(const IncrementalReclaimer&) = delete;
+        IncrementalReclaimer& operator=(const IncrementalReclaimer&) = delete;
+    };
+
+} // namespace resourceguard
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace resourceguard {
+
+    namespace detail {
+
+        /**
+         * @brief A guard retired by a foreign thread, waiting for its home thread
+         */
+        struct RetireNode {
+            RetireNode* next;
+            AnyResourceGuard<> guard;
+        };
+
+        /**
+         * @brief Per-thread multi-producer, single-consumer list of retired guards
+         *
+         * Any thread pushes with a lock-free CAS; the owning thread takes the whole list with one
+         * exchange. Lists are never freed: when a thread exits its list is handed to the next
+         * thread that needs one (like FailureRing), so guards retired to an exited thread are
+         * cleaned up by whichever thread adopts the list.
+         */
+        struct RetireList {
+            std::atomic<RetireNode*> head{nullptr};  ///< Most recently retired guard
+            std::atomic<bool> owned{true};           ///< Whether a live thread collects this list
+            RetireList* next = nullptr;              ///< Next list in the registry
+
+            void push(RetireNode* node) noexcept {
+                node->next = head.load(std::memory_order_relaxed);
+                while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                                   std::memory_order_relaxed)) {}
+            }
+
+            /**
+             * @brief Destroys every retired guard, oldest first
+             * @return The number of guards destroyed
+             */
+            std::size_t collect() noexcept {
+                RetireNode* node = head.exchange(nullptr, std::memory_order_acquire);
+                RetireNode* fifo = nullptr;
+                while (node) {
+                    RetireNode* following = node->next;
+                    node->next = fifo;
+                    fifo = node;
+                    node = following;
+                }
+                std::size_t collected = 0;
+                while (fifo) {
+                    RetireNode* following = fifo->next;
+                    delete fifo;
+                    fifo = following;
+                    ++collected;
+                }
+                return collected;
+            }
+        };
+
+        inline std::atomic<RetireList*> g_retire_lists{nullptr};
+
+        /**
+         * @brief The calling thread's list, or nullptr before first use and after thread exit
+         */
+        inline thread_local RetireList* t_retire_list = nullptr;
+
+        /**
+         * @brief Set once the calling thread has given its list up at thread exit
+         */
+        inline thread_local bool t_retire_list_released = false;
+
+        inline RetireList* acquire_retire_list() noexcept {
+            for (RetireList* l = g_retire_lists.load(std::memory_order_acquire); l; l = l->next) {
+                bool expected = false;
+                if (!l->owned.load(std::memory_order_relaxed) &&
+                    l->owned.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    return l;
+                }
+            }
+            RetireList* list = new (std::nothrow) RetireList;
+            if (!list) return nullptr;
+            list->next = g_retire_lists.load(std::memory_order_relaxed);
+            while (!g_retire_lists.compare_exchange_weak(list->next, list, std::memory_order_release,
+                                                         std::memory_order_relaxed)) {}
+            return list;
+        }
+
+        struct RetireListOwner {
+            RetireList* list = acquire_retire_list();
+            RetireListOwner() noexcept { t_retire_list = list; }
+            ~RetireListOwner() {
+                if (list) list->collect();
+                t_retire_list = nullptr;
+                t_retire_list_released = true;
+                if (list) list->owned.store(false, std::memory_order_release);
+            }
+        };
+
+        /**
+         * @brief Returns the calling thread's list, or nullptr if it has none
+         *
+         * Only reads trivially destructible thread-locals once the list has been given up at
+         * thread exit, so deleters run from other thread-locals' destructors may call it.
+         */
+        inline RetireList* thread_retire_list() noexcept {
+            if (RetireList* list = t_retire_list) return list;
+            if (t_retire_list_released) return nullptr;
+            thread_local RetireListOwner owner;
+            return owner.list;
+        }
+
+    } // namespace detail
+
+    /**
+     * @brief Deleter adaptor that runs the wrapped deleter on the thread that created it
+     *
+     * Construct it on the guard's home thread. When the guard is cleaned up there, the wrapped
+     * deleter runs immediately. When it is cleaned up on any other thread, the resources and a
+     * copy of the deleter are pushed onto the home thread's lock-free retire list, and the home
+     * thread runs the deleter at its next safe point, i.e. when it calls collect_retired().
+     * This keeps deleters that touch thread-local state (per-thread allocator caches, pools,
+     * event loops) free of cross-thread synchronization, like mimalloc's delayed free.
+     *
+     * A remote release costs one allocation and one CAS. If the allocation fails, the deleter
+     * runs on the releasing thread instead.
+     *
+     * A home thread collects its list once more when it exits. Guards released after that are
+     * still pushed onto the exited thread's list, and wait there until a new thread adopts the
+     * list (e.g. on its first HomeThread construction or collect_retired() call) and collects it.
+     * If no thread ever does, their deleters do not run.
+     *
+     * @code
+     * // home thread
+     * ResourceGuard<HomeThread<PoolFree>, Block*> block(HomeThread<PoolFree>(), pool_alloc());
+     * hand_to_worker(std::move(block));   // worker destroys it
+     * ...
+     * collect_retired();                   // home thread frees blocks released by workers
+     * @endcode
+     *
+     * @tparam Deleter The deleter to run on the home thread
+     */
+    template<typename Deleter>
+    class HomeThread : private detail::DeleterStorage<Deleter> {
+        using DeleterBase = detail::DeleterStorage<Deleter>;
+
+        detail::RetireList* m_home;
+
+    public:
+        /**
+         * @brief Binds the deleter to the calling thread
+         * @param deleter The wrapped deleter
+         */
+        explicit HomeThread(Deleter deleter = Deleter())
+            : DeleterBase(std::move(deleter)), m_home(detail::thread_retire_list()) {}
+
+        template<typename... Resources>
+        void operator()(Resources&... resources) noexcept {
+            if (detail::t_retire_list == m_home || !m_home) {
+                detail::invoke_deleter(this->deleter(), resources...);
+                return;
+            }
+            auto guard = make_resource_guard(this->deleter(), std::move(resources)...);
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            try {
+                m_home->push(new detail::RetireNode{ nullptr, AnyResourceGuard<>(std::move(guard)) });
+            } catch (...) {
+                // The local guard still owns the resources and cleans them up here.
+            }
+#else
+            m_home->push(new detail::RetireNode{ nullptr, AnyResourceGuard<>(std::move(guard)) });
+#endif
+        }
+
+        /**
+         * @brief Checks whether cleanup on the calling thread would run immediately
+         * @return true if called on the home thread
+         */
+        bool on_home_thread() const noexcept { return detail::t_retire_list == m_home; }
+    };
+
+    /**
+     * @brief Cleans up the guards that other threads retired to the calling thread
+     *
+     * Call at safe points of the home thread (e.g. once per event-loop iteration). Cheap when
+     * there is nothing to collect: a single atomic exchange.
+     *
+     * @return The number of guards cleaned up
+     */
+    inline std::size_t collect_retired() noexcept {
+        detail::RetireList* list = detail::thread_retire_list();
+        return list ? list->collect() : 0;
+    }
+
+    /**
+     * @brief Checks whether other threads have retired guards to the calling thread
+     * @return true if collect_retired() has work to do
+     */
+    inline bool has_retired() noexcept {
+        detail::RetireList* list = detail::thread_retire_list();
+        return list && list->head.load(std::memory_order_relaxed) != nullptr;
+    }
+
+} // namespace resourceguard
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "resourceguard.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RESOURCEGUARD_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define RESOURCEGUARD_X86_SIMD 0
+#endif
+
+namespace resourceguard {
+
+    /**
+     * @brief Instruction set used by scan_valid()
+     */
+    enum class SimdLevel {
+        Scalar,  ///< Portable loop
+        SSE2,    ///< 128-bit compares (x86)
+        AVX2     ///< 256-bit compares (x86)
+    };
+
+    namespace detail {
+
+        using ScanKernel = void (*)(const void* data, std::size_t count, std::uint64_t sentinel, std::uint64_t* out);
+
+        template<typename Word>
+        inline Word load_word(const void* data, std::size_t i) noexcept {
+            Word w;
+            std::memcpy(&w, static_cast<const unsigned char*>(data) + i * sizeof(Word), sizeof(Word));
+            return w;
+        }
+
+        /**
+         * @brief Sets bit i of out for every element i that differs from the sentinel
+         * 
+         * Starts at element `from`, which must be a multiple of 64 or continue a partially
+         * written word. Words are fully overwritten when their first element is written.
+         */
+        template<typename Word>
+        void scan_scalar(const void* data, std::size_t from, std::size_t count, std::uint64_t sentinel,
+                         std::uint64_t* out) noexcept {
+            const Word s = static_cast<Word>(sentinel);
+            for (std::size_t i = from; i < count; ++i) {
+                if (i % 64 == 0) out[i / 64] = 0;
+                out[i / 64] |= std::uint64_t(load_word<Word>(data, i) != s) << (i % 64);
+            }
+        }
+
+        template<typename Word>
+        void scan_scalar_kernel(const void* data, std::size_t count, std::uint64_t sentinel,
+                                std::uint64_t* out) noexcept {
+            scan_scalar<Word>(data, 0, count, sentinel, out);
+        }
+
+#if RESOURCEGUARD_X86_SIMD
+        inline void scan_sse2_32(const void* data, std::size_t count, std::uint64_t sentinel,
+                                 std::uint64_t* out) noexcept {
+            const __m128i s = _mm_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(sentinel)));
+            const auto* p = static_cast<const unsigned char*>(data);
+            std::size_t full = count / 64 * 64;
+            for (std::size_t base = 0; base < full; base += 64) {
+                std::uint64_t word = 0;
+                for (std::size_t i = 0; i < 64; i += 4) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + (base + i) * 4));
+                    unsigned eq = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, s))));
+                    word |= std::uint64_t(~eq & 0xFu) << i;
+                }
+                out[base / 64] = word;
+            }
+            scan_scalar<std::uint32_t>(data, full, count, sentinel, out);
+        }
+
+        inline void scan_sse2_64(const void* data, std::size_t count, std::uint64_t sentinel,
+                                 std::uint64_t* out) noexcept {
+            const __m128i s = _mm_set1_epi64x(static_cast<long long>(sentinel));
+            const auto* p = static_cast<const unsigned char*>(data);
+            std::size_t full = count / 64 * 64;
+            for (std::size_t base = 0; base < full; base += 64) {
+                std::uint64_t word = 0;
+                for (std::size_t i = 0; i < 64; i += 2) {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + (base + i) * 8));
+                    __m128i eq32 = _mm_cmpeq_epi32(v, s);
+                    __m128i eq64 = _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+                    unsigned eq = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(eq64)));
+                    word |= std::uint64_t(~eq & 0x3u) << i;
+                }
+                out[base / 64] = word;
+            }
+            scan_scalar<std::uint64_t>(data, full, count, sentinel, out);
+        }
+
+        __attribute__((target("avx2")))
+        inline void scan_avx2_32(const void* data, std::size_t count, std::uint64_t sentinel,
+                                 std::uint64_t* out) noexcept {
+            const __m256i s = _mm256_set1_epi32(static_cast<int>(static_cast<std::uint32_t>(sentinel)));
+            const auto* p = static_cast<const unsigned char*>(data);
+            std::size_t full = count / 64 * 64;
+            for (std::size_t base = 0; base < full; base += 64) {
+                std::uint64_t word = 0;
+                for (std::size_t i = 0; i < 64; i += 8) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + (base + i) * 4));
+                    unsigned eq = static_cast<unsigned>(
+                        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, s))));
+                    word |= std::uint64_t(~eq & 0xFFu) << i;
+                }
+                out[base / 64] = word;
+            }
+            scan_scalar<std::uint32_t>(data, full, count, sentinel, out);
+        }
+
+        __attribute__((target("avx2")))
+        inline void scan_avx2_64(const void* data, std::size_t count, std::uint64_t sentinel,
+                                 std::uint64_t* out) noexcept {
+            const __m256i s = _mm256_set1_epi64x(static_cast<long long>(sentinel));
+            const auto* p = static_cast<const unsigned char*>(data);
+            std::size_t full = count / 64 * 64;
+            for (std::size_t base = 0; base < full; base += 64) {
+                std::uint64_t word = 0;
+                for (std::size_t i = 0; i < 64; i += 4) {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + (base + i) * 8));
+                    unsigned eq = static_cast<unsigned>(
+                        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, s))));
+                    word |= std::uint64_t(~eq & 0xFu) << i;
+                }
+                out[base / 64] = word;
+            }
+            scan_scalar<std::uint64_t>(data, full, count, sentinel, out);
+        }
+#endif
+
+        inline SimdLevel detect_simd_level() noexcept {
+#if RESOURCEGUARD_X86_SIMD
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+            if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+            return SimdLevel::Scalar;
+        }
+
+        template<std::size_t Size>
+        ScanKernel scan_kernel(SimdLevel level) noexcept {
+            static_assert(Size == 4 || Size == 8, "Vectorized scans support 4- and 8-byte handles");
+#if RESOURCEGUARD_X86_SIMD
+            if (level == SimdLevel::AVX2) return Size == 4 ? &scan_avx2_32 : &scan_avx2_64;
+            if (level == SimdLevel::SSE2) return Size == 4 ? &scan_sse2_32 : &scan_sse2_64;
+#else
+            (void)level;
+#endif
+            if constexpr (Size == 4) return &scan_scalar_kernel<std::uint32_t>;
+            else return &scan_scalar_kernel<std::uint64_t>;
+        }
+
+        /**
+         * @brief Whether scans over T can compare raw bits against the sentinel
+         *
+         * Requires the built-in ValidityCheck, which the sentinel test already implies; a
+         * specialized ValidityCheck (e.g. fd >= 0) has to be called per handle.
+         */
+        template<typename T>
+        inline constexpr bool is_vector_scannable_v =
+            ResourceTraits<T>::has_sentinel && (sizeof(T) == 4 || sizeof(T) == 8) &&
+            (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) &&
+            std::is_base_of_v<SentinelValidity, ValidityCheck<const T&>>;
+
+    } // namespace detail
+
+    /**
+     * @brief Returns the best instruction set available on this CPU
+     * 
+     * Detected once at first use.
+     * 
+     * @return The detected SimdLevel
+     */
+    inline SimdLevel simd_level() noexcept {
+        static const SimdLevel level = detail::detect_simd_level();
+        return level;
+    }
+
+    /**
+     * @brief Computes a bitmap of valid handles with the given instruction set
+     * 
+     * See scan_valid(const T*, std::size_t, std::uint64_t*). Requesting a level the CPU
+     * does not support is undefined; pass simd_level() or a lower level.
+     * 
+     * @param handles The handles to scan
+     * @param count The number of handles
+     * @param out Receives (count + 63) / 64 words; bit i % 64 of word i / 64 is set if handle i is valid
+     * @param level The instruction set to use
+     */
+    template<typename T>
+    void scan_valid(const T* handles, std::size_t count, std::uint64_t* out, SimdLevel level) {
+        if constexpr (detail::is_vector_scannable_v<T>) {
+            using Word = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+            T sentinel_value = ResourceTraits<T>::sentinel();
+            Word sentinel;
+            std::memcpy(&sentinel, &sentinel_value, sizeof(Word));
+            detail::scan_kernel<sizeof(T)>(level)(handles, count, sentinel, out);
+        } else {
+            (void)level;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (i % 64 == 0) out[i / 64] = 0;
+                bool valid = ValidityCheck<const T&>::check(handles[i]);
+                if constexpr (ResourceTraits<T>::has_sentinel) {
+                    valid = valid && !(handles[i] == ResourceTraits<T>::sentinel());
+                }
+                out[i / 64] |= std::uint64_t(valid) << (i % 64);
+            }
+        }
+    }
+
+    /**
+     * @brief Computes a bitmap of valid handles
+     * 
+     * For 4- and 8-byte integral, enum and pointer handles with a sentinel (see ResourceTraits)
+     * and no ValidityCheck specialization, a handle is valid if it differs from the sentinel;
+     * these are compared with AVX2 or SSE2 when available (selected at runtime), with a scalar
+     * fallback. Other handle types are checked one by one with ValidityCheck (and their
+     * sentinel, if any). Bits past count in the last word are cleared.
+     *
+     * Plain int file descriptors have no sentinel and are not vectorized; wrap them in an enum
+     * with one, e.g. `enum class Fd : int {}` with `SentinelTraits<Fd, Fd{-1}>`.
+     * 
+     * @param handles The handles to scan
+     * @param count The number of handles
+     * @param out Receives (count + 63) / 64 words; bit i % 64 of word i / 64 is set if handle i is valid
+     */
+    template<typename T>
+    void scan_valid(const T* handles, std::size_t count, std::uint64_t* out) {
+        scan_valid(handles, count, out, simd_level());
+    }
+
+} // namespace resourceguard
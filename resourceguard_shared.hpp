@@ -0,0 +1,529 @@
+#pragma once
+
+#include "resourceguard.hpp"
+#include "resourceguard_retire.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace resourceguard {
+
+    /**
+     * @brief Counting policy for guards shared across threads
+     *
+     * Copies add a relaxed atomic increment, drops an acquire-release decrement, like
+     * std::shared_ptr.
+     */
+    struct AtomicCount {
+        class Counter {
+            std::atomic<long> m_count{1};
+
+        public:
+            void increment() noexcept { m_count.fetch_add(1, std::memory_order_relaxed); }
+
+            /**
+             * @brief Drops one reference
+             * @return true if it was the last one
+             */
+            bool decrement() noexcept {
+                if (m_count.fetch_sub(1, std::memory_order_release) != 1) return false;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return true;
+            }
+
+            long use_count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+        };
+    };
+
+    /**
+     * @brief Counting policy for guards that never leave one thread
+     *
+     * Plain integer arithmetic; copying or dropping copies of the same guard on two threads is
+     * a data race.
+     */
+    struct NonAtomicCount {
+        class Counter {
+            long m_count = 1;
+
+        public:
+            void increment() noexcept { ++m_count; }
+
+            /**
+             * @brief Drops one reference
+             * @return true if it was the last one
+             */
+            bool decrement() noexcept { return --m_count == 0; }
+
+            long use_count() const noexcept { return m_count; }
+        };
+    };
+
+    namespace detail {
+
+        /**
+         * @brief Part of a shared control block that does not depend on the allocator
+         *
+         * The counter is a base, so a counting policy can get from its counter to the block
+         * (see BiasedCount).
+         *
+         * @tparam CountPolicy The counting policy (AtomicCount, NonAtomicCount, BiasedCount)
+         */
+        template<typename CountPolicy>
+        struct SharedControl : CountPolicy::Counter {
+            void (*dispose)(SharedControl* self) noexcept;  ///< Cleans up, destroys and deallocates the block
+
+            explicit SharedControl(void (*d)(SharedControl*) noexcept) noexcept : dispose(d) {}
+        };
+
+        /**
+         * @brief Reference count, deleter and resources of a shared guard
+         */
+        template<typename CountPolicy, typename Deleter, typename... Resources>
+        struct SharedPayload : SharedControl<CountPolicy>, DeleterStorage<Deleter> {
+            std::tuple<Resources...> resources;  ///< The managed resources
+
+            template<typename D, typename... Args>
+            SharedPayload(void (*d)(SharedControl<CountPolicy>*) noexcept, D&& deleter, Args&&... args)
+                : SharedControl<CountPolicy>(d),
+                  DeleterStorage<Deleter>(std::forward<D>(deleter)),
+                  resources(std::forward<Args>(args)...) {}
+        };
+
+        /**
+         * @brief The single allocation behind a shared guard, including the allocator that made it
+         *
+         * The allocator is kept as an empty base when stateless (e.g. std::allocator) and
+         * rebound to the block type to allocate and free it.
+         */
+        template<typename Alloc, typename CountPolicy, typename Deleter, typename... Resources>
+        struct SharedBlock : SharedPayload<CountPolicy, Deleter, Resources...>, private Alloc {
+            using Payload = SharedPayload<CountPolicy, Deleter, Resources...>;
+            using Control = SharedControl<CountPolicy>;
+            using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<SharedBlock>;
+
+            template<typename D, typename... Args>
+            SharedBlock(const Alloc& alloc, D&& deleter, Args&&... args)
+                : Payload(&dispose_block, std::forward<D>(deleter), std::forward<Args>(args)...), Alloc(alloc) {}
+
+            static void dispose_block(Control* control) noexcept {
+                auto* block = static_cast<SharedBlock*>(control);
+                std::apply([block](Resources&... resources) {
+                    invoke_deleter(block->deleter(), resources...);
+                }, block->resources);
+                BlockAlloc alloc(static_cast<Alloc&>(*block));
+                block->~SharedBlock();
+                std::allocator_traits<BlockAlloc>::deallocate(alloc, block, 1);
+            }
+
+            /**
+             * @brief Allocates and constructs a block
+             *
+             * If allocation throws, the resources are cleaned up before the exception propagates.
+             * If constructing the deleter or a resource in the block throws, the memory is given
+             * back and the exception propagates.
+             */
+            template<typename D, typename... Args>
+            static SharedBlock* create(const Alloc& allocator, D&& deleter, Args&&... args) {
+                BlockAlloc alloc(allocator);
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+                SharedBlock* block;
+                try {
+                    block = std::allocator_traits<BlockAlloc>::allocate(alloc, 1);
+                } catch (...) {
+                    // Like std::shared_ptr, do not leak the resources the caller handed over.
+                    Deleter cleanup(std::forward<D>(deleter));
+                    std::tuple<Resources...> resources(std::forward<Args>(args)...);
+                    std::apply([&cleanup](Resources&... r) { invoke_deleter(cleanup, r...); }, resources);
+                    throw;
+                }
+                try {
+                    ::new (static_cast<void*>(block)) SharedBlock(allocator, std::forward<D>(deleter), std::forward<Args>(args)...);
+                } catch (...) {
+                    std::allocator_traits<BlockAlloc>::deallocate(alloc, block, 1);
+                    throw;
+                }
+#else
+                SharedBlock* block = std::allocator_traits<BlockAlloc>::allocate(alloc, 1);
+                ::new (static_cast<void*>(block)) SharedBlock(allocator, std::forward<D>(deleter), std::forward<Args>(args)...);
+#endif
+                return block;
+            }
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Counting policy for guards mostly copied and dropped on the thread that created them
+     *
+     * Biased reference counting: the creating (owner) thread counts its references with plain
+     * integer arithmetic, other threads count theirs atomically in a separate field. When the
+     * owner's count drops to zero, the two are merged and every later operation is atomic.
+     *
+     * A reference created on the owner and dropped on another thread makes the atomic count
+     * negative; the first time that happens, the block is queued on the owner's retire list
+     * (see HomeThread) and merged when the owner calls collect_retired(), or when it exits.
+     * Owner threads that hand copies to other threads should therefore call collect_retired()
+     * at safe points, or those resources are only cleaned up at owner thread exit. The queued
+     * merge holds a reference of its own, so the block outlives its retire node. If the
+     * owner's retire list cannot be allocated, the block counts atomically from the start.
+     *
+     * Queueing the merge allocates a retire node on the dropping thread. There is no fallback
+     * if that allocation fails, since only the owner may touch its plain count: it is reported
+     * through the misuse handler, which aborts by default. Use AtomicCount where a foreign drop
+     * must not allocate.
+     */
+    struct BiasedCount {
+        class Counter {
+            static constexpr std::int64_t merged_bit = 1;  ///< All counting is atomic from now on
+            static constexpr std::int64_t queued_bit = 2;  ///< A merge is pending on the owner thread
+            static constexpr std::int64_t one = 4;         ///< One reference in m_shared
+
+            detail::RetireList* m_owner;          ///< Retire list identifying the owner thread
+            long m_local = 1;                     ///< References counted by the owner, owner-only
+            std::atomic<std::int64_t> m_shared;   ///< (references << 2) | queued_bit | merged_bit
+
+            bool on_owner() const noexcept {
+                return detail::t_retire_list == m_owner && !(m_shared.load(std::memory_order_relaxed) & merged_bit);
+            }
+
+            /**
+             * @brief Runs on the owner thread: folds m_local into m_shared and drops the queued reference
+             */
+            static void merge_queued(detail::SharedControl<BiasedCount>* control) noexcept {
+                Counter& counter = *control;
+                // Only the owner sets merged_bit, so this relaxed load is current.
+                bool merged = counter.m_shared.load(std::memory_order_relaxed) & merged_bit;
+                std::int64_t local = merged ? 0 : std::exchange(counter.m_local, 0);
+                std::int64_t delta = local * one + (merged ? 0 : merged_bit) - one - queued_bit;
+                std::int64_t after = counter.m_shared.fetch_add(delta, std::memory_order_acq_rel) + delta;
+                if ((after >> 2) == 0) control->dispose(control);
+            }
+
+            void queue_merge() noexcept {
+                auto* control = static_cast<detail::SharedControl<BiasedCount>*>(this);
+                detail::RetireNode* node = nullptr;
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+                try {
+                    node = new detail::RetireNode{ nullptr, AnyResourceGuard<>(make_resource_guard<&merge_queued>(control)) };
+                } catch (...) {
+                    detail::report_misuse("Out of memory queueing a biased reference count merge");
+                }
+#else
+                node = new detail::RetireNode{ nullptr, AnyResourceGuard<>(make_resource_guard<&merge_queued>(control)) };
+#endif
+                m_owner->push(node);
+            }
+
+        public:
+            Counter() noexcept : m_owner(detail::thread_retire_list()), m_shared(0) {
+                if (!m_owner) {
+                    m_local = 0;
+                    m_shared.store(one | merged_bit, std::memory_order_relaxed);
+                }
+            }
+
+            void increment() noexcept {
+                if (on_owner()) {
+                    ++m_local;
+                } else {
+                    m_shared.fetch_add(one, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * @brief Drops one reference
+             * @return true if it was the last one
+             */
+            bool decrement() noexcept {
+                if (on_owner()) {
+                    if (--m_local != 0) return false;
+                    // A queued merge holds a reference of its own, so the count cannot reach
+                    // zero here while the retire node still points at the block.
+                    std::int64_t merged = m_shared.fetch_add(merged_bit, std::memory_order_acq_rel) + merged_bit;
+                    return (merged >> 2) == 0;
+                }
+                std::int64_t shared = m_shared.load(std::memory_order_relaxed);
+                if (shared & merged_bit) return ((m_shared.fetch_sub(one, std::memory_order_acq_rel) - one) >> 2) == 0;
+                std::int64_t next;
+                do {
+                    next = shared - one;
+                    // The first time the count goes negative, queue a merge that holds one reference.
+                    if (!(next & (merged_bit | queued_bit)) && (next >> 2) < 0) next += one | queued_bit;
+                } while (!m_shared.compare_exchange_weak(shared, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+                if (next & merged_bit) return (next >> 2) == 0;
+                if ((next & queued_bit) && !(shared & queued_bit)) queue_merge();
+                return false;
+            }
+
+            /**
+             * @brief Number of references
+             *
+             * Exact on the owner thread and once merged, not counting the reference held by a
+             * pending merge. On other threads before the merge the owner's references cannot be
+             * read, so only a lower bound of 1 is reported.
+             */
+            long use_count() const noexcept {
+                std::int64_t shared = m_shared.load(std::memory_order_relaxed);
+                if (detail::t_retire_list == m_owner || (shared & merged_bit)) {
+                    std::int64_t count = (shared >> 2) - ((shared & queued_bit) ? 1 : 0);
+                    return static_cast<long>(count + ((shared & merged_bit) ? 0 : m_local));
+                }
+                return 1;
+            }
+        };
+    };
+
+    /**
+     * @class BasicSharedResourceGuard
+     * @brief Reference-counted guard whose count, deleter and resources share one allocation
+     *
+     * Copies share the resources; the deleter runs once, when the last copy is destroyed or
+     * reset. Unlike std::shared_ptr with a custom deleter, there is no separate control block:
+     * the guard is one pointer to a block holding the count, the deleter and the resource
+     * tuple, allocated with std::allocator or the allocator passed to
+     * allocate_shared_resource_guard() (e.g. a pool). Like shared_ptr, the last copy disposes
+     * of the block through a function pointer stored in it, which calls the deleter directly.
+     *
+     * A guard over a single resource holding its sentinel (see ResourceTraits), such as a null
+     * pointer, allocates nothing and is empty, like a released ResourceGuard. Accessing an
+     * empty guard is reported through the default check policy.
+     *
+     * @code
+     * auto file = resourceguard::make_shared_resource_guard(FileCloser{}, fopen("log.txt", "a"));
+     * auto copy = file;                     // use_count() == 2, no allocation
+     * fputs("hello\n", copy.get());
+     * @endcode
+     *
+     * @tparam CountPolicy AtomicCount, NonAtomicCount for guards confined to one thread, or
+     *                     BiasedCount for guards mostly used on the thread that created them
+     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename CountPolicy, typename Deleter, typename... Resources>
+    class BasicSharedResourceGuard {
+        static_assert(sizeof...(Resources) > 0, "A shared guard needs at least one resource");
+
+        using Control = detail::SharedControl<CountPolicy>;
+        using Payload = detail::SharedPayload<CountPolicy, Deleter, Resources...>;
+
+        Payload* m_block = nullptr;  ///< The shared block, or nullptr if empty
+
+        template<typename... Args>
+        static bool holds_sentinel(const Args&... args) noexcept {
+            if constexpr (detail::encodes_release_v<Resources...> && sizeof...(Args) == 1) {
+                using Traits = ResourceTraits<std::tuple_element_t<0, std::tuple<Resources...>>>;
+                return ((args == Traits::sentinel()) && ...);
+            } else {
+                return false;
+            }
+        }
+
+        void check_live() const noexcept(RESOURCEGUARD_DEFAULT_CHECK_POLICY::is_nothrow) {
+            if constexpr (RESOURCEGUARD_DEFAULT_CHECK_POLICY::enabled) {
+                if (!m_block) RESOURCEGUARD_DEFAULT_CHECK_POLICY::fail("Shared guard is empty");
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructs an empty guard
+         */
+        BasicSharedResourceGuard() noexcept = default;
+
+        /**
+         * @brief Allocates a block with std::allocator and takes ownership of the resources
+         *
+         * @param deleter The cleanup function to call when the last copy goes away
+         * @param args The resources to manage
+         * @throws std::bad_alloc if the block cannot be allocated, after cleaning up the resources
+         */
+        template<typename D, typename... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(Resources)>>
+        explicit BasicSharedResourceGuard(D&& deleter, Args&&... args)
+            : BasicSharedResourceGuard(std::allocator_arg, std::allocator<char>(),
+                                       std::forward<D>(deleter), std::forward<Args>(args)...) {}
+
+        /**
+         * @brief Allocates a block with the given allocator and takes ownership of the resources
+         *
+         * @param alloc The allocator for the block; it is rebound, and a copy is kept in the block to free it
+         * @param deleter The cleanup function to call when the last copy goes away
+         * @param args The resources to manage
+         * @throws Whatever the allocator throws, after cleaning up the resources
+         */
+        template<typename Alloc, typename D, typename... Args,
+                 typename = std::enable_if_t<sizeof...(Args) == sizeof...(Resources)>>
+        BasicSharedResourceGuard(std::allocator_arg_t, const Alloc& alloc, D&& deleter, Args&&... args) {
+            if (holds_sentinel(args...)) return;
+            using Block = detail::SharedBlock<Alloc, CountPolicy, Deleter, Resources...>;
+            m_block = Block::create(alloc, std::forward<D>(deleter), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Destructor, cleans up the resources if this was the last copy
+         */
+        ~BasicSharedResourceGuard() { reset(); }
+
+        /**
+         * @brief Copy constructor, shares the resources
+         */
+        BasicSharedResourceGuard(const BasicSharedResourceGuard& other) noexcept : m_block(other.m_block) {
+            if (m_block) m_block->increment();
+        }
+
+        /**
+         * @brief Move constructor, leaves the source empty
+         */
+        BasicSharedResourceGuard(BasicSharedResourceGuard&& other) noexcept : m_block(other.m_block) {
+            other.m_block = nullptr;
+        }
+
+        /**
+         * @brief Copy assignment, drops the current resources and shares the other guard's
+         */
+        BasicSharedResourceGuard& operator=(const BasicSharedResourceGuard& other) noexcept {
+            Payload* block = other.m_block;
+            if (block) block->increment();
+            reset();
+            m_block = block;
+            return *this;
+        }
+
+        /**
+         * @brief Move assignment, drops the current resources and takes the other guard's
+         */
+        BasicSharedResourceGuard& operator=(BasicSharedResourceGuard&& other) noexcept {
+            if (this != &other) {
+                reset();
+                m_block = other.m_block;
+                other.m_block = nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Drops this reference, cleaning up the resources if it was the last one
+         *
+         * The guard is empty afterwards.
+         */
+        void reset() noexcept {
+            if (!m_block) return;
+            Control* control = std::exchange(m_block, nullptr);
+            if (control->decrement()) control->dispose(control);
+        }
+
+        /**
+         * @brief Accesses the first resource
+         *
+         * @return Reference to the first resource
+         * @throws std::logic_error if the guard is empty (ThrowingCheck)
+         */
+        decltype(auto) get() const noexcept(RESOURCEGUARD_DEFAULT_CHECK_POLICY::is_nothrow) {
+            check_live();
+            return std::get<0>(std::as_const(m_block->resources));
+        }
+
+        /**
+         * @brief Accesses a specific resource by index
+         *
+         * @tparam I The index of the resource to access
+         * @return Reference to the specified resource
+         * @throws std::logic_error if the guard is empty (ThrowingCheck)
+         */
+        template<size_t I>
+        decltype(auto) get() const noexcept(RESOURCEGUARD_DEFAULT_CHECK_POLICY::is_nothrow) {
+            static_assert(I < sizeof...(Resources), "Invalid resource index");
+            check_live();
+            return std::get<I>(std::as_const(m_block->resources));
+        }
+
+        /**
+         * @brief Number of guards sharing the resources, 0 if empty
+         *
+         * Only a snapshot under AtomicCount while other threads copy or drop the guard.
+         */
+        long use_count() const noexcept { return m_block ? m_block->use_count() : 0; }
+
+        /**
+         * @brief Checks whether the guard holds resources
+         */
+        explicit operator bool() const noexcept { return m_block != nullptr; }
+    };
+
+    /**
+     * @brief Thread-safe shared guard
+     *
+     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename Deleter, typename... Resources>
+    using SharedResourceGuard = BasicSharedResourceGuard<AtomicCount, Deleter, Resources...>;
+
+    /**
+     * @brief Shared guard for use on a single thread, counting without atomic instructions
+     *
+     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename Deleter, typename... Resources>
+    using LocalSharedResourceGuard = BasicSharedResourceGuard<NonAtomicCount, Deleter, Resources...>;
+
+    /**
+     * @brief Shared guard that counts without atomic instructions on the thread that created it
+     *
+     * See BiasedCount.
+     *
+     * @tparam Deleter A callable type that handles resource cleanup
+     * @tparam Resources The types of resources to manage
+     */
+    template<typename Deleter, typename... Resources>
+    using BiasedSharedResourceGuard = BasicSharedResourceGuard<BiasedCount, Deleter, Resources...>;
+
+    /**
+     * @brief Shared guards relocate by memcpy: they are a single pointer to their block
+     */
+    template<typename CountPolicy, typename Deleter, typename... Resources>
+    struct is_trivially_relocatable<BasicSharedResourceGuard<CountPolicy, Deleter, Resources...>> : std::true_type {};
+
+    /**
+     * @brief Creates a shared guard with type deduction
+     *
+     * @code
+     * auto fd = resourceguard::make_shared_resource_guard(FdCloser{}, open(path, O_RDONLY));
+     * auto local = resourceguard::make_shared_resource_guard<resourceguard::NonAtomicCount>(FdCloser{}, dup(fd.get()));
+     * @endcode
+     *
+     * @tparam CountPolicy AtomicCount (default), NonAtomicCount or BiasedCount
+     * @param deleter Function object that will be called to clean up resources
+     * @param args The resources to manage
+     * @return A BasicSharedResourceGuard managing the given resources
+     */
+    template<typename CountPolicy = AtomicCount, typename Deleter, typename... Args>
+    auto make_shared_resource_guard(Deleter&& deleter, Args&&... args) {
+        return BasicSharedResourceGuard<CountPolicy, std::decay_t<Deleter>, std::decay_t<Args>...>(
+            std::forward<Deleter>(deleter), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Creates a shared guard whose block comes from the given allocator
+     *
+     * The allocator is rebound to the block type, so any std-style allocator works, including
+     * fixed-size pools: every block of one guard type has the same size.
+     *
+     * @tparam CountPolicy AtomicCount (default), NonAtomicCount or BiasedCount
+     * @param alloc The allocator for the block
+     * @param deleter Function object that will be called to clean up resources
+     * @param args The resources to manage
+     * @return A BasicSharedResourceGuard managing the given resources
+     */
+    template<typename CountPolicy = AtomicCount, typename Alloc, typename Deleter, typename... Args>
+    auto allocate_shared_resource_guard(const Alloc& alloc, Deleter&& deleter, Args&&... args) {
+        return BasicSharedResourceGuard<CountPolicy, std::decay_t<Deleter>, std::decay_t<Args>...>(
+            std::allocator_arg, alloc, std::forward<Deleter>(deleter), std::forward<Args>(args)...);
+    }
+
+} // namespace resourceguard
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "resourceguard.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace resourceguard {
+
+    /**
+     * @class GuardVector
+     * @brief Growable array of guards that relocates with memcpy when it can
+     *
+     * A std::vector of guards grows by move-constructing every element into the new buffer and
+     * destroying the old ones. For guards marked is_trivially_relocatable, GuardVector instead
+     * grows with realloc (which may extend in place or remap pages) and moves elements on
+     * erase with memmove. Other element types fall back to the move-and-destroy loop.
+     *
+     * Elements are destroyed in reverse order of their position.
+     *
+     * @tparam T The element type, usually a ResourceGuard or ResourceGroup
+     */
+    template<typename T>
+    class GuardVector {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Elements must be nothrow move constructible");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned elements are not supported");
+
+        T* m_data = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;
+
+        static constexpr bool relocatable = is_trivially_relocatable_v<T>;
+
+        void destroy_range(T* first, T* last) noexcept {
+            while (last != first) (--last)->~T();
+        }
+
+        RESOURCEGUARD_COLD static void allocation_failed() {
+#if RESOURCEGUARD_HAS_EXCEPTIONS
+            throw std::bad_alloc();
+#else
+            detail::report_misuse("Out of memory growing a GuardVector");
+#endif
+        }
+
+        void reallocate(std::size_t capacity) {
+            if (capacity > SIZE_MAX / sizeof(T)) allocation_failed();
+            T* data;
+            if constexpr (relocatable) {
+                data = static_cast<T*>(std::realloc(static_cast<void*>(m_data), capacity * sizeof(T)));
+                if (!data) allocation_failed();
+            } else {
+                data = static_cast<T*>(std::malloc(capacity * sizeof(T)));
+                if (!data) allocation_failed();
+                for (std::size_t i = 0; i < m_size; ++i) {
+                    ::new (static_cast<void*>(data + i)) T(std::move(m_data[i]));
+                    m_data[i].~T();
+                }
+                std::free(m_data);
+            }
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        void grow() {
+            if (m_capacity > SIZE_MAX / 2) allocation_failed();
+            reallocate(m_capacity ? m_capacity * 2 : 8);
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        GuardVector() noexcept = default;
+
+        /**
+         * @brief Destructor, destroys the elements in reverse order
+         */
+        ~GuardVector() {
+            clear();
+            std::free(m_data);
+        }
+
+        /**
+         * @brief Move constructor, takes over the buffer
+         */
+        GuardVector(GuardVector&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr)),
+              m_size(std::exchange(other.m_size, 0)),
+              m_capacity(std::exchange(other.m_capacity, 0)) {}
+
+        /**
+         * @brief Move assignment, destroys the current elements and takes over the buffer
+         */
+        GuardVector& operator=(GuardVector&& other) noexcept {
+            if (this != &other) {
+                clear();
+                std::free(m_data);
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+                m_capacity = std::exchange(other.m_capacity, 0);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Ensures room for at least capacity elements without reallocation
+         * @param capacity The number of elements to reserve space for
+         * @throws std::bad_alloc if allocation fails (misuse handler when exceptions are disabled)
+         */
+        void reserve(std::size_t capacity) {
+            if (capacity > m_capacity) reallocate(capacity);
+        }
+
+        /**
+         * @brief Constructs an element at the end
+         *
+         * When the vector is full, the element is constructed before the buffer grows, so the
+         * arguments may refer to elements of this vector. If growing then fails, that element
+         * is destroyed, which cleans up its resources.
+         *
+         * @tparam Args Constructor argument types (deduced)
+         * @param args Arguments for T's constructor, e.g. a deleter and resources
+         * @return Reference to the new element
+         * @throws std::bad_alloc if growing fails; whatever T's constructor throws
+         */
+        template<typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (m_size == m_capacity) {
+                T value(std::forward<Args>(args)...);
+                grow();
+                return *::new (static_cast<void*>(m_data + m_size++)) T(std::move(value));
+            }
+            T* slot = ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Args>(args)...);
+            ++m_size;
+            return *slot;
+        }
+
+        /**
+         * @brief Moves an element to the end
+         * @param value The element to take over
+         * @return Reference to the new element
+         */
+        T& push_back(T&& value) {
+            return emplace_back(std::move(value));
+        }
+
+        /**
+         * @brief Destroys the last element, cleaning up its resources
+         */
+        void pop_back() noexcept {
+            m_data[--m_size].~T();
+        }
+
+        /**
+         * @brief Destroys an element and closes the gap
+         *
+         * @param pos The element to destroy
+         * @return Iterator to the element that followed the erased one
+         */
+        iterator erase(const_iterator pos) noexcept {
+            T* target = m_data + (pos - m_data);
+            target->~T();
+            T* last = m_data + m_size;
+            if constexpr (relocatable) {
+                std::memmove(static_cast<void*>(target), static_cast<const void*>(target + 1),
+                             static_cast<std::size_t>(last - target - 1) * sizeof(T));
+            } else {
+                for (T* p = target; p + 1 != last; ++p) {
+                    ::new (static_cast<void*>(p)) T(std::move(p[1]));
+                    p[1].~T();
+                }
+            }
+            --m_size;
+            return target;
+        }
+
+        /**
+         * @brief Destroys an element and moves the last element into its place
+         *
+         * O(1), but does not preserve order.
+         *
+         * @param index The position of the element to destroy
+         */
+        void swap_remove(std::size_t index) noexcept {
+            T* target = m_data + index;
+            target->~T();
+            T* last = m_data + --m_size;
+            if (target == last) return;
+            if constexpr (relocatable) {
+                std::memcpy(static_cast<void*>(target), static_cast<const void*>(last), sizeof(T));
+            } else {
+                ::new (static_cast<void*>(target)) T(std::move(*last));
+                last->~T();
+            }
+        }
+
+        /**
+         * @brief Destroys all elements in reverse order, keeping the capacity
+         */
+        void clear() noexcept {
+            destroy_range(m_data, m_data + m_size);
+            m_size = 0;
+        }
+
+        T& operator[](std::size_t index) noexcept { return m_data[index]; }
+        const T& operator[](std::size_t index) const noexcept { return m_data[index]; }
+
+        T& back() noexcept { return m_data[m_size - 1]; }
+        const T& back() const noexcept { return m_data[m_size - 1]; }
+
+        T* data() noexcept { return m_data; }
+        const T* data() const noexcept { return m_data; }
+
+        iterator begin() noexcept { return m_data; }
+        iterator end() noexcept { return m_data + m_size; }
+        const_iterator begin() const noexcept { return m_data; }
+        const_iterator end() const noexcept { return m_data + m_size; }
+
+        std::size_t size() const noexcept { return m_size; }
+        std::size_t capacity() const noexcept { return m_capacity; }
+        bool empty() const noexcept { return m_size == 0; }
+
+        /**
+         * @brief Copy constructor (deleted)
+         */
+        GuardVector(const GuardVector&) = delete;
+
+        /**
+         * @brief Copy assignment (deleted)
+         */
+        GuardVector& operator=(const GuardVector&) = delete;
+    };
+
+} // namespace resourceguard
@@ -0,0 +1,187 @@
+/**
+ * @file resourceguard_noexcept.cpp
+ * @brief Checks that every header compiles and runs with exceptions disabled
+ *
+ * Build and run from the repository root:
+ *
+ *   g++ -std=c++17 -fno-exceptions -Wall -Wextra -pthread -I. tests/resourceguard_noexcept.cpp \
+ *       -o resourceguard_noexcept && ./resourceguard_noexcept
+ *
+ * Instantiates the public class templates explicitly, so members that are never called are
+ * compiled too, and exercises each header once.
+ */
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS)
+#error "Build this file with -fno-exceptions"
+#endif
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+#include "resourceguard_arena.hpp"
+#include "resourceguard_array.hpp"
+#include "resourceguard_deferred.hpp"
+#include "resourceguard_epoch.hpp"
+#include "resourceguard_exitstack.hpp"
+#include "resourceguard_hazard.hpp"
+#include "resourceguard_reclaim.hpp"
+#include "resourceguard_retire.hpp"
+#include "resourceguard_scan.hpp"
+#include "resourceguard_shared.hpp"
+#include "resourceguard_vector.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+    int g_cleaned = 0;
+
+    struct Cleaner {
+        void operator()(int*) const noexcept { ++g_cleaned; }
+        void operator()(int) const noexcept { ++g_cleaned; }
+        void operator()(int*, int) const noexcept { ++g_cleaned; }
+    };
+
+    struct BatchCleaner {
+        void operator()(int) const noexcept { ++g_cleaned; }
+        void destroy_batch(int*, std::size_t count) const noexcept { g_cleaned += static_cast<int>(count); }
+    };
+
+    struct MayThrowCleaner {
+        void operator()(int*) const { ++g_cleaned; }
+    };
+
+    void clean_pointer(int*) noexcept { ++g_cleaned; }
+
+} // namespace
+
+namespace resourceguard {
+
+    template class BasicResourceGuard<ThrowingCheck, Cleaner, int*>;
+    template class BasicResourceGuard<HandlerCheck, Cleaner, int*>;
+    template class BasicResourceGuard<AssertingCheck, Cleaner, int*, int>;
+    template class BasicResourceGuard<NoCheck, MayThrowCleaner, int*>;
+    template class BasicResourceGroup<ThrowingCheck, std::tuple<Cleaner, Cleaner>, int*, int>;
+    template class ResourceGuardArray<BatchCleaner, int>;
+    template class GuardVector<ResourceGuard<Cleaner, int*>>;
+    template class GuardVector<std::unique_ptr<int>>;
+    template class AnyResourceGuard<>;
+    template class ExitStack<>;
+    template class BasicSharedResourceGuard<AtomicCount, Cleaner, int*>;
+    template class BasicSharedResourceGuard<NonAtomicCount, Cleaner, int*>;
+    template class BasicSharedResourceGuard<BiasedCount, Cleaner, int*>;
+    template class HomeThread<Cleaner>;
+    template class EpochRetire<Cleaner>;
+    template class HazardRetire<Cleaner>;
+    template class Async<Cleaner>;
+
+} // namespace resourceguard
+
+using namespace resourceguard;
+
+int main() {
+    int value = 0;
+    int expected = 0;
+
+    {
+        auto guard = make_resource_guard(Cleaner{}, &value);
+        auto fn_guard = make_resource_guard<&clean_pointer>(&value);
+        auto group = make_resource_group(std::make_tuple(Cleaner{}, Cleaner{}), &value, 1);
+        auto conn = acquisition().acquire([&value] { return &value; }, Cleaner{}).commit();
+        expected += 5;
+    }
+
+    {
+        ResourceGuardArray<BatchCleaner, int> array;
+        for (int fd = 3; fd < 10; ++fd) array.push_back(fd);
+        std::uint64_t bits[1];
+        array.valid_bits(bits);
+        expected += 7;
+    }
+
+    {
+        GuardVector<ResourceGuard<Cleaner, int*>> guards;
+        for (int i = 0; i < 20; ++i) guards.emplace_back(Cleaner{}, &value);
+        expected += 20;
+    }
+
+    {
+        AnyResourceGuard<> any(make_resource_guard(Cleaner{}, &value));
+        ExitStack<> stack;
+        stack.emplace(Cleaner{}, &value);
+        stack.callback([] { ++g_cleaned; });
+        ExitStack<> moved = stack.pop_all();
+        expected += 3;
+    }
+
+    {
+        Arena arena;
+        arena.make_guard(ArenaDeleter{}, arena.allocate_array<char>(64));
+        arena.make_guard(Cleaner{}, &value);
+        arena.reset();
+        expected += 1;
+    }
+
+    {
+        ResourceGuard<Deferred<BatchCleaner>, int> deferred(Deferred<BatchCleaner>{}, 3);
+    }
+    flush_deferred();
+    expected += 1;
+
+    {
+        AsyncReclaimer reclaimer({ 16, 1, Backpressure::Block });
+        ResourceGuard<Async<Cleaner>, int*> async(Async<Cleaner>(reclaimer), &value);
+        async.release();
+        reclaimer.drain();
+        IncrementalReclaimer incremental;
+        incremental.retire(make_resource_guard(Cleaner{}, &value));
+        incremental.drain();
+        expected += 2;
+    }
+
+    {
+        ResourceGuard<HomeThread<Cleaner>, int*> home(HomeThread<Cleaner>(), &value);
+        collect_retired();
+        expected += 1;
+    }
+
+    {
+        EpochPin pin;
+        ResourceGuard<EpochRetire<Cleaner>, int*> retired(EpochRetire<Cleaner>(), &value);
+    }
+    epoch_barrier();
+    expected += 1;
+
+    {
+        std::atomic<int*> shared{&value};
+        HazardPointer hp;
+        hp.protect(shared);
+        hp.reset();
+        hazard_retire(&value, make_resource_guard(Cleaner{}, &value));
+        while (hazard_pending() != 0) hazard_reclaim();
+        expected += 1;
+    }
+
+    {
+        int* handles[] = { &value, nullptr, &value };
+        std::uint64_t bits[1];
+        scan_valid(handles, 3, bits);
+        if (bits[0] != 0b101) return 1;
+    }
+
+    {
+        auto shared = make_shared_resource_guard(Cleaner{}, &value);
+        auto local = make_shared_resource_guard<NonAtomicCount>(Cleaner{}, &value);
+        auto biased = allocate_shared_resource_guard<BiasedCount>(std::allocator<char>(), Cleaner{}, &value);
+        auto copy = biased;
+        expected += 3;
+    }
+
+    if (g_cleaned != expected) {
+        std::fprintf(stderr, "cleaned %d resources, expected %d\n", g_cleaned, expected);
+        return 1;
+    }
+    std::puts("ok");
+    return 0;
+}
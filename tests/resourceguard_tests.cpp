@@ -0,0 +1,798 @@
+/**
+ * @file resourceguard_tests.cpp
+ * @brief Runtime tests, meant to run under AddressSanitizer and UndefinedBehaviorSanitizer
+ *
+ * Build and run from the repository root:
+ *
+ *   g++ -std=c++17 -g -O1 -fsanitize=address,undefined -fno-sanitize-recover=all -pthread -I. \
+ *       tests/resourceguard_tests.cpp -o resourceguard_tests
+ *   ./resourceguard_tests
+ *
+ * Each test is a function registered in main(); a failed check prints its location and the
+ * program exits with a non-zero status after running the remaining tests. The layout checks
+ * (guard sizes and relocatability) are static_asserts and fail the build instead.
+ */
+
+#include "resourceguard.hpp"
+#include "resourceguard_any.hpp"
+#include "resourceguard_arena.hpp"
+#include "resourceguard_array.hpp"
+#include "resourceguard_deferred.hpp"
+#include "resourceguard_epoch.hpp"
+#include "resourceguard_exitstack.hpp"
+#include "resourceguard_hazard.hpp"
+#include "resourceguard_reclaim.hpp"
+#include "resourceguard_retire.hpp"
+#include "resourceguard_scan.hpp"
+#include "resourceguard_shared.hpp"
+#include "resourceguard_vector.hpp"
+
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+enum class Fd : int {};
+enum class CheckedFd : int {};
+
+template<>
+struct resourceguard::ResourceTraits<Fd> : resourceguard::SentinelTraits<Fd, Fd{-1}> {};
+template<>
+struct resourceguard::ResourceTraits<CheckedFd> : resourceguard::SentinelTraits<CheckedFd, CheckedFd{-1}> {};
+template<>
+struct resourceguard::ValidityCheck<const CheckedFd&> {
+    static bool check(const CheckedFd& fd) { return static_cast<int>(fd) >= 0; }
+};
+
+using namespace resourceguard;
+
+namespace {
+
+    int g_failures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++g_failures;                                                                 \
+        }                                                                                 \
+    } while (false)
+
+    /**
+     * @brief Deleter counting how many resources it cleaned up
+     */
+    struct CountingDeleter {
+        std::atomic<int>* count;
+        template<typename... Resources>
+        void operator()(Resources&...) const noexcept { count->fetch_add(1, std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief Tree node whose deleter retires its children through the same scheme
+     */
+    struct Node {
+        std::vector<Node*> children;
+    };
+
+    constexpr int fanout = 100;  // more than the retirement thresholds, so cleanup re-enters a scan
+
+    std::atomic<int> g_nodes_deleted{0};
+
+    /**
+     * @brief Compile-time layout checks for sentinel-encoded storage and deleter elision
+     */
+    namespace layout {
+
+        struct StatelessDeleter {
+            template<typename... Args>
+            void operator()(Args&&...) const noexcept {}
+        };
+
+        struct StatefulDeleter {
+            void* context;
+            template<typename... Args>
+            void operator()(Args&&...) const noexcept {}
+        };
+
+        struct FinalDeleter final : StatelessDeleter {};
+
+        using FreeFn = void (*)(void*);
+
+        void free_fn(void*) noexcept {}
+
+        using detail::ResourceStorageFor;
+
+        // Sentinel-encoded resources carry no release flag.
+        static_assert(sizeof(ResourceStorageFor<void*>) == sizeof(void*), "pointer storage must not carry a release flag");
+        static_assert(sizeof(ResourceStorageFor<const char*>) == sizeof(const char*), "pointer storage must not carry a release flag");
+        static_assert(sizeof(ResourceStorageFor<int>) > sizeof(int), "storage without a sentinel needs a release flag");
+        static_assert(sizeof(ResourceStorageFor<void*, void*>) > 2 * sizeof(void*), "multi-resource storage needs a release flag");
+
+        // Stateless deleters occupy no storage.
+        static_assert(sizeof(ResourceGuard<StatelessDeleter, void*>) == sizeof(void*), "stateless pointer guard must be pointer-sized");
+        static_assert(sizeof(ResourceGuard<StatelessDeleter, int*>) == sizeof(int*), "stateless pointer guard must be pointer-sized");
+        static_assert(sizeof(ResourceGuard<StatelessDeleter, int>) == sizeof(ResourceStorageFor<int>), "stateless deleter must not add storage");
+        static_assert(sizeof(ResourceGuard<StatelessDeleter, void*, int>) == sizeof(ResourceStorageFor<void*, int>), "stateless deleter must not add storage");
+        static_assert(sizeof(FnResourceGuard<&free_fn, void*>) == sizeof(void*), "compile-time deleter must not add storage");
+
+        // Resource groups add only a liveness mask for stateless deleters.
+        static_assert(sizeof(ResourceGroup<std::tuple<StatelessDeleter, StatelessDeleter>, int, int>) == 3 * sizeof(int), "group must add only a mask");
+        static_assert(sizeof(ResourceGroup<std::tuple<StatelessDeleter, StatelessDeleter>, void*, void*>) == 3 * sizeof(void*), "group must add only a mask");
+
+        // Stateful deleters, function pointers and final classes are stored as members.
+        static_assert(sizeof(ResourceGuard<FreeFn, void*>) == 2 * sizeof(void*), "function pointer deleter is stored next to the resource");
+        static_assert(sizeof(ResourceGuard<StatefulDeleter, void*>) == 2 * sizeof(void*), "stateful deleter is stored next to the resource");
+        static_assert(sizeof(ResourceGuard<FinalDeleter, void*>) == 2 * sizeof(void*), "final deleter cannot use the empty base");
+
+        // Guards over plain handles and deleters relocate by memcpy.
+        static_assert(is_trivially_relocatable_v<ResourceGuard<StatelessDeleter, void*>>, "pointer guard must be relocatable");
+        static_assert(is_trivially_relocatable_v<ResourceGuard<FreeFn, int>>, "flagged guard must be relocatable");
+        static_assert(is_trivially_relocatable_v<ResourceGroup<std::tuple<StatelessDeleter, FreeFn>, int, void*>>, "group must be relocatable");
+        static_assert(!is_trivially_relocatable_v<ResourceGuard<std::function<void(void*)>, void*>>, "opaque deleter must not be assumed relocatable");
+
+    } // namespace layout
+
+    /**
+     * @brief Deleter counting cleanups, and cleanups handed the sentinel
+     */
+    struct SentinelCountingDeleter {
+        std::atomic<int>* count;
+        std::atomic<int>* sentinels;
+        void operator()(int* p) const noexcept { note(p == nullptr); }
+        void operator()(Fd fd) const noexcept { note(fd == Fd{ -1 }); }
+        void note(bool sentinel) const noexcept {
+            count->fetch_add(1, std::memory_order_relaxed);
+            if (sentinel) sentinels->fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    void test_sentinel_guard() {
+        std::atomic<int> count{0};
+        std::atomic<int> sentinels{0};
+        SentinelCountingDeleter deleter{ &count, &sentinels };
+        {
+            ResourceGuard<SentinelCountingDeleter, int*> null_guard(deleter, nullptr);
+            ResourceGuard<SentinelCountingDeleter, Fd> closed_fd(deleter, Fd{ -1 });
+            CHECK(!null_guard);
+            CHECK(!closed_fd);
+            CHECK(!null_guard.try_steal());  // constructed from the sentinel: already released
+            CHECK(!closed_fd.try_steal());
+            null_guard.release();            // no-op
+            closed_fd.release();
+        }
+        CHECK(count == 0);
+
+        int value = 0;
+        {
+            ResourceGuard<SentinelCountingDeleter, int*> guard(deleter, &value);
+            ResourceGuard<SentinelCountingDeleter, Fd> fd(deleter, Fd{ 3 });
+            ResourceGuard<SentinelCountingDeleter, Fd> moved(std::move(fd));  // fd now holds the sentinel
+            CHECK(!fd);
+            guard.release();
+            guard.release();  // second release is a no-op
+            CHECK(count == 1);
+            CHECK(!guard);
+            CHECK(guard.rearm(&value) == 0);
+        }
+        CHECK(count == 3);
+        CHECK(sentinels == 0);  // the deleter never saw nullptr or -1
+    }
+
+    void test_guard_cleanup() {
+        std::atomic<int> count{0};
+        {
+            ResourceGuard<CountingDeleter, int> guard(CountingDeleter{ &count }, 1);
+            ResourceGuard<CountingDeleter, int> moved(std::move(guard));
+            CHECK(count == 0);
+        }
+        CHECK(count == 1);
+    }
+
+    /**
+     * @brief Deleter appending each cleaned-up value to a log, to check cleanup order
+     */
+    struct LoggingDeleter {
+        std::vector<int>* log;
+        void operator()(int value) const noexcept { log->push_back(value); }
+        void operator()(Fd fd) const noexcept { log->push_back(static_cast<int>(fd)); }
+    };
+
+    void test_group_release_and_reverse_destruction() {
+        std::vector<int> log;
+        {
+            LoggingDeleter deleter{ &log };
+            auto group = make_resource_group(std::make_tuple(deleter, deleter, deleter, deleter), 1, 2, 3, 4);
+            group.release<1>();
+            CHECK((log == std::vector<int>{ 2 }));
+            CHECK(!group.owns<1>());
+            CHECK(group.owns<0>() && group.owns<2>() && group.owns<3>());
+            group.release<1>();  // already released: no-op
+            CHECK(log.size() == 1);
+            CHECK(group.steal<2>() == 3);  // stolen: never cleaned up
+        }
+        CHECK((log == std::vector<int>{ 2, 4, 1 }));  // the rest in reverse order
+    }
+
+    void test_acquisition_commit_and_rollback() {
+        std::vector<int> log;
+        LoggingDeleter deleter{ &log };
+        {
+            auto conn = acquisition()
+                .acquire([] { return Fd{ 3 }; }, deleter)
+                .acquire([](Fd first) { return Fd{ static_cast<int>(first) + 1 }; }, deleter)
+                .commit();
+            CHECK(conn.has_value());
+            CHECK(conn->get<1>() == Fd{ 4 });
+            CHECK(log.empty());
+        }
+        CHECK((log == std::vector<int>{ 4, 3 }));
+
+        // A sentinel result rolls back in reverse order and skips the remaining steps.
+        log.clear();
+        bool skipped_step_ran = false;
+        auto sentinel = acquisition()
+            .acquire([] { return Fd{ 3 }; }, deleter)
+            .acquire([] { return Fd{ 4 }; }, deleter)
+            .acquire([] { return Fd{ -1 }; }, deleter)
+            .acquire([&] { skipped_step_ran = true; return Fd{ 6 }; }, deleter)
+            .commit();
+        CHECK(!sentinel);
+        CHECK(!skipped_step_ran);
+        CHECK((log == std::vector<int>{ 4, 3 }));
+
+        log.clear();
+        auto empty = acquisition()
+            .acquire([] { return Fd{ 3 }; }, deleter)
+            .acquire([] { return std::optional<Fd>(); }, deleter)
+            .commit();
+        CHECK(!empty);
+        CHECK((log == std::vector<int>{ 3 }));
+
+        log.clear();
+        bool caught = false;
+        try {
+            acquisition()
+                .acquire([] { return Fd{ 3 }; }, deleter)
+                .acquire([] { return Fd{ 4 }; }, deleter)
+                .acquire([]() -> Fd { throw std::runtime_error("open failed"); }, deleter)
+                .commit();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK((log == std::vector<int>{ 4, 3 }));
+    }
+
+    void test_reset_emplace_rearm() {
+        std::vector<int> log;
+        LoggingDeleter deleter{ &log };
+        {
+            ResourceGuard<LoggingDeleter, int> guard(deleter, 1);
+            guard.reset(2);
+            CHECK((log == std::vector<int>{ 1 }));
+            guard.emplace(3);
+            CHECK((log == std::vector<int>{ 1, 2 }));
+            CHECK(guard.rearm(4) == 1);  // still owns 3: unchanged
+            CHECK(guard.get() == 3);
+            guard.release();
+            CHECK(guard.rearm(5) == 0);
+            guard.release();
+            guard.reset(6);  // released: nothing to dispose of
+            CHECK((log == std::vector<int>{ 1, 2, 3, 5 }));
+        }
+        CHECK((log == std::vector<int>{ 1, 2, 3, 5, 6 }));
+
+        log.clear();
+        {
+            ResourceGuard<LoggingDeleter, Fd> fd(deleter, Fd{ 7 });
+            fd.reset(Fd{ -1 });  // resetting to the sentinel leaves the guard released
+            CHECK(!fd);
+            fd.emplace(8);
+        }
+        CHECK((log == std::vector<int>{ 7, 8 }));
+    }
+
+    void test_contiguous_runs_at_type_limits() {
+        int handles[] = { INT_MAX, 5, INT_MIN, INT_MAX - 1, 4, INT_MAX, 7 };
+        std::vector<std::pair<int, int>> runs;
+        for_each_contiguous_run(handles, 7, [&runs](int first, int last) { runs.emplace_back(first, last); });
+        CHECK((runs == std::vector<std::pair<int, int>>{ { INT_MIN, INT_MIN }, { 4, 5 }, { 7, 7 }, { INT_MAX - 1, INT_MAX } }));
+    }
+
+    /**
+     * @brief Batch deleter recording single and batched cleanups separately
+     */
+    struct RecordingBatchDeleter {
+        std::vector<int>* singles;
+        std::vector<int>* batched;
+        void operator()(int fd) const noexcept { singles->push_back(fd); }
+        void destroy_batch(int* fds, std::size_t count) const noexcept { batched->insert(batched->end(), fds, fds + count); }
+    };
+
+    void test_array_batch_receives_live_handles() {
+        std::vector<int> singles;
+        std::vector<int> batched;
+        {
+            ResourceGuardArray<RecordingBatchDeleter, int> array(RecordingBatchDeleter{ &singles, &batched });
+            for (int fd = 0; fd < 130; ++fd) array.push_back(fd);
+            array.release(3);
+            array.release(64);
+            array.release(129);
+            array.release(3);  // already released: no-op
+            CHECK(array.steal(70) == 70);
+            CHECK((singles == std::vector<int>{ 3, 64, 129 }));
+            CHECK(array.live_count() == 126);
+        }
+        std::vector<int> expected;
+        for (int fd = 0; fd < 130; ++fd) {
+            if (fd != 3 && fd != 64 && fd != 70 && fd != 129) expected.push_back(fd);
+        }
+        CHECK(batched == expected);  // only the live handles, compacted, in index order
+        CHECK(singles.size() == 3);
+    }
+
+    void test_exit_stack_lifo_pop_all_and_callback() {
+        std::vector<int> log;
+        LoggingDeleter deleter{ &log };
+        {
+            ExitStack<2> kept;
+            {
+                ExitStack<2> stack;  // entries 0 and 1 inline, 2-5 in the first chunk, 6-8 in the second
+                for (int i = 0; i < 9; ++i) {
+                    if (i == 4) stack.callback([&log] { log.push_back(100); });
+                    else stack.emplace(deleter, i);
+                }
+                CHECK(stack.size() == 9);
+                kept = stack.pop_all();
+                CHECK(stack.size() == 0);
+                CHECK(kept.size() == 9);
+            }
+            CHECK(log.empty());  // the emptied stack cleaned up nothing
+        }
+        CHECK((log == std::vector<int>{ 8, 7, 6, 5, 100, 3, 2, 1, 0 }));
+
+        log.clear();
+        ExitStack<2> stack;
+        for (int i = 0; i < 5; ++i) stack.emplace(deleter, i);
+        stack.close();
+        CHECK((log == std::vector<int>{ 4, 3, 2, 1, 0 }));
+        CHECK(stack.size() == 0);
+    }
+
+    /**
+     * @brief Logging deleter that lets an Arena skip it on reset
+     */
+    struct ElidedLoggingDeleter {
+        static constexpr bool elide_on_arena_reset = true;
+        std::vector<int>* log;
+        void operator()(int value) const noexcept { log->push_back(value); }
+    };
+
+    static_assert(elide_on_arena_reset_v<ResourceGuard<ElidedLoggingDeleter, int>>, "deleter opts in");
+    static_assert(!elide_on_arena_reset_v<ResourceGuard<LoggingDeleter, int>>, "deleter does not opt in");
+
+    void test_arena_reset_skips_elided_cleanups() {
+        std::vector<int> log;
+        {
+            Arena arena;
+            for (int round = 0; round < 2; ++round) {
+                arena.make_guard(LoggingDeleter{ &log }, 1);
+                arena.make_guard(ElidedLoggingDeleter{ &log }, 2);
+                arena.create<int>(0);
+                arena.make_guard(ArenaDeleter{}, arena.allocate_array<char>(64));
+                arena.make_guard(LoggingDeleter{ &log }, 3);
+                if (round == 0) {
+                    arena.reset();
+                    CHECK((log == std::vector<int>{ 3, 1 }));
+                }
+            }
+        }  // the destructor resets the second round
+        CHECK((log == std::vector<int>{ 3, 1, 3, 1 }));
+    }
+
+    struct HazardDeleteNode {
+        void operator()(Node* node) const noexcept {
+            for (Node* child : node->children) hazard_retire(child, make_resource_guard(HazardDeleteNode{}, child));
+            delete node;
+            g_nodes_deleted.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    struct EpochDeleteNode {
+        void operator()(Node* node) const noexcept {
+            for (Node* child : node->children) epoch_retire(make_resource_guard(EpochDeleteNode{}, child));
+            delete node;
+            g_nodes_deleted.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    void test_epoch_reentrant_retire() {
+        g_nodes_deleted = 0;
+        for (int round = 0; round < 4; ++round) {
+            Node* parent = new Node;
+            for (int i = 0; i < fanout; ++i) parent->children.push_back(new Node);
+            EpochRetire<EpochDeleteNode>()(parent);
+        }
+        epoch_barrier();
+        CHECK(g_nodes_deleted == 4 * (fanout + 1));
+    }
+
+    void test_hazard_reentrant_retire() {
+        g_nodes_deleted = 0;
+        for (int round = 0; round < 4; ++round) {
+            Node* parent = new Node;
+            for (int i = 0; i < fanout; ++i) parent->children.push_back(new Node);
+            HazardRetire<HazardDeleteNode>()(parent);
+        }
+        while (hazard_pending() != 0) hazard_reclaim();
+        CHECK(g_nodes_deleted == 4 * (fanout + 1));
+    }
+
+    void test_home_thread_cross_thread_release() {
+        std::atomic<int> count{0};
+        std::vector<ResourceGuard<HomeThread<CountingDeleter>, int>> guards;
+        for (int i = 0; i < 64; ++i) guards.emplace_back(HomeThread<CountingDeleter>(CountingDeleter{ &count }), i);
+        std::thread([&guards] { guards.clear(); }).join();
+        CHECK(count == 0);
+        CHECK(collect_retired() == 64);
+        CHECK(count == 64);
+    }
+
+    void test_guard_vector_self_push_back() {
+        std::atomic<int> count{0};
+        {
+            GuardVector<ResourceGuard<CountingDeleter, int>> guards;
+            guards.emplace_back(CountingDeleter{ &count }, 0);
+            while (guards.size() < guards.capacity()) guards.emplace_back(CountingDeleter{ &count }, 1);
+            guards.push_back(std::move(guards[0]));  // grows while the argument lives in the old buffer
+            CHECK(guards.back().get() == 0);
+            CHECK(count == 0);
+        }
+        CHECK(count == 8);  // the moved-from first element owns nothing
+    }
+
+    struct ThrowingDeleter {
+        void operator()(int) const { throw std::runtime_error("close failed"); }
+    };
+
+    /**
+     * @brief Thread-local constructed before the failure ring's owner, so destroyed after it
+     */
+    struct FailAtThreadExit {
+        ~FailAtThreadExit() { ResourceGuard<ThrowingDeleter, int> guard(ThrowingDeleter{}, 1); }
+    };
+
+    void test_cleanup_failure_during_thread_exit() {
+        drain_cleanup_failures([](const CleanupFailure&) {});
+        std::uint64_t dropped = dropped_cleanup_failures();
+        std::thread([] {
+            thread_local FailAtThreadExit fail_at_exit;
+            (void)fail_at_exit;
+            ResourceGuard<ThrowingDeleter, int> guard(ThrowingDeleter{}, 0);  // creates the ring
+        }).join();
+        // The failure at exit must not go into the ring the thread already gave up.
+        CHECK(drain_cleanup_failures([](const CleanupFailure&) {}) == 1);
+        CHECK(dropped_cleanup_failures() == dropped + 1);
+    }
+
+    std::atomic<int> g_deferred_cleaned{0};
+
+    /**
+     * @brief Stateless deleter for Deferred, counting into g_deferred_cleaned
+     */
+    struct DeferredCounter {
+        void operator()(int) const noexcept { g_deferred_cleaned.fetch_add(1, std::memory_order_relaxed); }
+    };
+
+    using DeferredGuard = ResourceGuard<Deferred<DeferredCounter, 4>, int>;
+
+    void test_deferred_threshold_flush() {
+        g_deferred_cleaned = 0;
+        for (int i = 0; i < 3; ++i) DeferredGuard(Deferred<DeferredCounter, 4>{}, i);
+        CHECK(g_deferred_cleaned == 0);
+        CHECK((pending_deferred<DeferredCounter, int>() == 3));
+        DeferredGuard(Deferred<DeferredCounter, 4>{}, 3);  // reaches the threshold
+        CHECK(g_deferred_cleaned == 4);
+        CHECK((pending_deferred<DeferredCounter, int>() == 0));
+        DeferredGuard(Deferred<DeferredCounter, 4>{}, 4);
+        flush_deferred();
+        CHECK(g_deferred_cleaned == 5);
+    }
+
+    /**
+     * @brief Thread-local constructed before the deferred queue, so destroyed after it
+     */
+    struct DeferAtThreadExit {
+        ~DeferAtThreadExit() { DeferredGuard guard(Deferred<DeferredCounter, 4>{}, 1); }
+    };
+
+    void test_deferred_thread_exit() {
+        g_deferred_cleaned = 0;
+        std::thread([] {
+            thread_local DeferAtThreadExit defer_at_exit;
+            (void)defer_at_exit;
+            DeferredGuard(Deferred<DeferredCounter, 4>{}, 0);  // creates the queue
+            DeferredGuard(Deferred<DeferredCounter, 4>{}, 1);
+            CHECK(g_deferred_cleaned == 0);
+        }).join();
+        // Two flushed with the queue, one cleaned up immediately once the queue was gone.
+        CHECK(g_deferred_cleaned == 3);
+    }
+
+    /**
+     * @brief Deferred deleter that retires through epoch and hazard reclamation
+     */
+    struct DeferredRetire {
+        void operator()(int value) const noexcept {
+            epoch_retire(make_resource_guard(DeferredCounter{}, value));
+            hazard_retire(&g_deferred_cleaned, make_resource_guard(DeferredCounter{}, value));
+        }
+    };
+
+    void test_deferred_flush_after_records_released() {
+        g_deferred_cleaned = 0;
+        std::thread([] {
+            ResourceGuard<Deferred<DeferredRetire>, int>(Deferred<DeferredRetire>{}, 0);  // creates the queue
+            // Registered after the queue, so given up before it flushes at thread exit.
+            CHECK(epoch_pending() == 0);
+            CHECK(hazard_pending() == 0);
+        }).join();
+        CHECK(g_deferred_cleaned == 2);  // retired through borrowed records, not left behind
+    }
+
+    void test_empty_any_guard() {
+        std::atomic<int> count{0};
+        AnyResourceGuard<> empty;
+        empty.release();
+        empty.reset();
+        CHECK(!empty.has_value());
+        CHECK(!empty);
+
+        AnyResourceGuard<> held(make_resource_guard(CountingDeleter{ &count }, 1));
+        AnyResourceGuard<> moved(std::move(held));
+        held.release();  // moved-from: empty, so a no-op
+        CHECK(count == 0);
+        moved.release();
+        CHECK(count == 1);
+    }
+
+    void test_scan_applies_validity_check() {
+        Fd fds[130];
+        CheckedFd checked[130];
+        for (int i = 0; i < 130; ++i) {
+            int value = i % 5 == 0 ? -1 : i % 7 == 0 ? -2 : i;
+            fds[i] = Fd{ value };
+            checked[i] = CheckedFd{ value };
+        }
+        for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 }) {
+            if (level > simd_level()) break;
+            std::uint64_t fd_bits[3];
+            std::uint64_t checked_bits[3];
+            scan_valid(fds, 130, fd_bits, level);
+            scan_valid(checked, 130, checked_bits, level);
+            for (int i = 0; i < 130; ++i) {
+                bool fd_valid = (fd_bits[i / 64] >> (i % 64)) & 1;
+                bool checked_valid = (checked_bits[i / 64] >> (i % 64)) & 1;
+                CHECK(fd_valid == (i % 5 != 0));  // only the sentinel is invalid
+                CHECK(checked_valid == (i % 5 != 0 && i % 7 != 0));  // ValidityCheck rejects -2 too
+            }
+        }
+    }
+
+    template<typename T>
+    struct FailingAllocator {
+        using value_type = T;
+        FailingAllocator() = default;
+        template<typename U>
+        FailingAllocator(const FailingAllocator<U>&) noexcept {}
+        T* allocate(std::size_t) { throw std::bad_alloc(); }
+        void deallocate(T*, std::size_t) noexcept {}
+        template<typename U>
+        bool operator==(const FailingAllocator<U>&) const noexcept { return true; }
+        template<typename U>
+        bool operator!=(const FailingAllocator<U>&) const noexcept { return false; }
+    };
+
+    void test_shared_guard_allocation_failure() {
+        std::atomic<int> count{0};
+        bool threw = false;
+        try {
+            allocate_shared_resource_guard(FailingAllocator<char>(), CountingDeleter{ &count }, 7);
+        } catch (const std::bad_alloc&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(count == 1);  // the handle was cleaned up, not leaked
+    }
+
+    /**
+     * @brief Splits n iterations of fn across the given number of threads and waits for them
+     */
+    template<typename Fn>
+    void run_on_threads(std::size_t threads, std::uint64_t n, Fn fn) {
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&fn, n, threads, t] { fn(n / threads + (t < n % threads ? 1 : 0)); });
+        }
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    void test_shared_count_reaches_zero_once() {
+        std::atomic<int> count{0};
+        for (int round = 0; round < 20; ++round) {
+            SharedResourceGuard<CountingDeleter, int> guard(CountingDeleter{ &count }, round);
+            run_on_threads(8, 20000, [&guard](std::uint64_t m) {
+                for (std::uint64_t i = 0; i < m; ++i) {
+                    SharedResourceGuard<CountingDeleter, int> copy = guard;
+                }
+            });
+            CHECK(guard.use_count() == 1);
+            CHECK(count == round);
+
+            // Hand every worker a reference and drop ours first, so a worker drops the last one.
+            std::vector<SharedResourceGuard<CountingDeleter, int>> handed(8, guard);
+            guard.reset();
+            std::atomic<std::size_t> next{0};
+            run_on_threads(8, 8, [&handed, &next](std::uint64_t) {
+                handed[next.fetch_add(1, std::memory_order_relaxed)].reset();
+            });
+            CHECK(count == round + 1);
+        }
+        CHECK(count == 20);
+
+        std::atomic<int> local_count{0};
+        {
+            LocalSharedResourceGuard<CountingDeleter, int> local(CountingDeleter{ &local_count }, 1);
+            std::vector<LocalSharedResourceGuard<CountingDeleter, int>> copies(100, local);
+            CHECK(local.use_count() == 101);
+            copies.clear();
+            CHECK(local.use_count() == 1);
+            CHECK(local_count == 0);
+        }
+        CHECK(local_count == 1);
+    }
+
+    using BiasedGuard = BiasedSharedResourceGuard<CountingDeleter, int>;
+
+    void test_biased_owner_drops_foreign_copy() {
+        // The owner drops a reference copied on another thread while a merge is queued.
+        std::atomic<int> count{0};
+        BiasedGuard a(CountingDeleter{ &count }, 1);
+        BiasedGuard a2 = a;
+        BiasedGuard a3 = a;
+        BiasedGuard a4;
+        std::thread([&] {
+            a2.reset();  // count goes negative: merge queued on the owner
+            a4 = a3;
+        }).join();
+        a.reset();
+        a3.reset();
+        a4.reset();
+        CHECK(count == 0);  // the queued merge still holds the block
+        CHECK(collect_retired() == 1);
+        CHECK(count == 1);
+    }
+
+    void test_biased_cross_thread_share_and_drop() {
+        std::atomic<int> count{0};
+        for (int round = 0; round < 50; ++round) {
+            BiasedGuard owner(CountingDeleter{ &count }, round);
+            std::vector<BiasedGuard> handed(8, owner);
+            std::vector<std::thread> workers;
+            for (BiasedGuard& guard : handed) {
+                workers.emplace_back([held = std::move(guard)]() mutable {
+                    for (int i = 0; i < 1000; ++i) {
+                        BiasedGuard copy = held;
+                        held = copy;
+                    }
+                });
+            }
+            for (int i = 0; i < 1000; ++i) {
+                BiasedGuard copy = owner;
+            }
+            owner.reset();
+            for (std::thread& worker : workers) worker.join();
+            collect_retired();
+        }
+        CHECK(count == 50);
+    }
+
+    void test_reclaimer_drain_and_shutdown() {
+        std::atomic<int> count{0};
+        AsyncReclaimer reclaimer(ReclaimerOptions{ 16, 2, Backpressure::Block });
+        for (int i = 0; i < 100; ++i) {
+            CHECK(reclaimer.retire(make_resource_guard(CountingDeleter{ &count }, i)));
+        }
+        reclaimer.drain();
+        CHECK(count == 100);
+        CHECK(reclaimer.backlog() == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            reclaimer.retire(make_resource_guard(CountingDeleter{ &count }, i));
+        }
+        reclaimer.shutdown();
+        CHECK(count == 110);  // the queue is drained before the workers exit
+        CHECK(!reclaimer.retire(make_resource_guard(CountingDeleter{ &count }, 0)));
+        CHECK(count == 111);  // cleaned up inline
+        reclaimer.shutdown();
+    }
+
+    /**
+     * @brief Deleter that retires further guards into the reclaimer running it
+     */
+    struct ReclaimingDeleter {
+        AsyncReclaimer* reclaimer;
+        std::atomic<int>* count;
+        int children;
+        bool shutdown;
+        void operator()(int&) const noexcept {
+            count->fetch_add(1, std::memory_order_relaxed);
+            for (int i = 0; i < children; ++i) {
+                reclaimer->retire(make_resource_guard(CountingDeleter{ count }, i));
+            }
+            if (shutdown) reclaimer->shutdown();
+        }
+    };
+
+    void test_reclaimer_retire_from_deleter() {
+        // One slot, one worker: the worker's own retires overflow and must not wait for it.
+        std::atomic<int> count{0};
+        {
+            AsyncReclaimer reclaimer(ReclaimerOptions{ 1, 1, Backpressure::Block });
+            for (int i = 0; i < 4; ++i) {
+                ReclaimingDeleter deleter{ &reclaimer, &count, 5, false };
+                reclaimer.retire(make_resource_guard(deleter, i));
+            }
+            reclaimer.drain();
+            CHECK(count == 4 * 6);
+        }
+
+        // A deleter shutting the reclaimer down does not join its own worker.
+        count = 0;
+        {
+            AsyncReclaimer reclaimer(ReclaimerOptions{ 8, 2, Backpressure::Block });
+            reclaimer.retire(make_resource_guard(ReclaimingDeleter{ &reclaimer, &count, 3, true }, 0));
+            reclaimer.shutdown();
+            CHECK(count == 4);
+        }
+    }
+
+} // namespace
+
+int main() {
+    test_guard_cleanup();
+    test_sentinel_guard();
+    test_group_release_and_reverse_destruction();
+    test_acquisition_commit_and_rollback();
+    test_reset_emplace_rearm();
+    test_contiguous_runs_at_type_limits();
+    test_array_batch_receives_live_handles();
+    test_exit_stack_lifo_pop_all_and_callback();
+    test_arena_reset_skips_elided_cleanups();
+    test_epoch_reentrant_retire();
+    test_hazard_reentrant_retire();
+    test_home_thread_cross_thread_release();
+    test_guard_vector_self_push_back();
+    test_cleanup_failure_during_thread_exit();
+    test_deferred_threshold_flush();
+    test_deferred_thread_exit();
+    test_deferred_flush_after_records_released();
+    test_empty_any_guard();
+    test_scan_applies_validity_check();
+    test_shared_guard_allocation_failure();
+    test_shared_count_reaches_zero_once();
+    test_biased_owner_drops_foreign_copy();
+    test_biased_cross_thread_share_and_drop();
+    test_reclaimer_drain_and_shutdown();
+    test_reclaimer_retire_from_deleter();
+    if (g_failures) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return 1;
+    }
+    std::puts("all tests passed");
+    return 0;
+}